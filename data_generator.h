@@ -0,0 +1,185 @@
+// data_generator.h - Seeded input generators for the sorting benchmarks
+//
+// Shared by main.c (int arrays) and sorting_assignment.c (the ID column of generated
+// Student records). All randomness comes from xoshiro256** seeded through splitmix64, so
+// a (distribution, n, seed) triple always produces the same data on every platform,
+// unlike rand(), whose sequence and RAND_MAX depend on the C library.
+
+#ifndef DATA_GENERATOR_H
+#define DATA_GENERATOR_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// --- xoshiro256** PRNG ---
+
+typedef struct {
+    uint64_t s[4];
+} Xoshiro256;
+
+static inline uint64_t splitmix64_next(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Expands a 64-bit seed into the 256-bit state (never all zero)
+static inline void xoshiro_seed(Xoshiro256* rng, uint64_t seed) {
+    for (int i = 0; i < 4; i++) rng->s[i] = splitmix64_next(&seed);
+}
+
+static inline uint64_t xoshiro_rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static inline uint64_t xoshiro_next(Xoshiro256* rng) {
+    uint64_t* s = rng->s;
+    uint64_t result = xoshiro_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = xoshiro_rotl(s[3], 45);
+    return result;
+}
+
+// Uniform integer in [0, bound) without modulo bias (bound > 0)
+static inline uint64_t xoshiro_below(Xoshiro256* rng, uint64_t bound) {
+    uint64_t threshold = (0 - bound) % bound; // 2^64 mod bound
+    while (1) {
+        uint64_t r = xoshiro_next(rng);
+        if (r >= threshold) return r % bound;
+    }
+}
+
+// Uniform double in [0, 1)
+static inline double xoshiro_double(Xoshiro256* rng) {
+    return (double)(xoshiro_next(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// --- Distributions ---
+
+typedef enum {
+    DIST_UNIFORM,       // Independent uniform values
+    DIST_SORTED,        // Non-decreasing
+    DIST_REVERSE,       // Non-increasing
+    DIST_NEARLY_SORTED, // Sorted, then 1% of the positions swapped with a random partner
+    DIST_FEW_UNIQUE,    // Uniform over DATA_GEN_FEW_UNIQUE distinct values
+    DIST_ORGAN_PIPE,    // Ascending first half, descending second half
+    DIST_SAWTOOTH,      // DATA_GEN_SAWTOOTH_TEETH ascending runs
+    DIST_ZIPF,          // Zipf(DATA_GEN_ZIPF_EXPONENT): a few values dominate
+    DIST_COUNT
+} DataDistribution;
+
+#define DATA_GEN_FEW_UNIQUE 16
+#define DATA_GEN_SAWTOOTH_TEETH 16
+#define DATA_GEN_ZIPF_EXPONENT 1.0
+#define DATA_GEN_ZIPF_MAX_RANKS 65536 // Size of the Zipf CDF table
+
+static const char* const data_distribution_names[DIST_COUNT] = {
+    "uniform", "sorted", "reverse", "nearly-sorted", "few-unique", "organ-pipe", "sawtooth", "zipf"
+};
+
+// Index of the named distribution, or -1
+static inline int data_distribution_from_name(const char* name) {
+    for (int i = 0; i < DIST_COUNT; i++) {
+        if (strcmp(name, data_distribution_names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+// Position i of n mapped linearly onto [0, max_value]
+static inline int data_gen_scale(size_t i, size_t n, int max_value) {
+    return (int)((double)i * ((double)max_value + 1.0) / (double)n);
+}
+
+// Fills arr[0, n) with values in [0, max_value] following dist. Returns 0 only if the Zipf
+// table cannot be allocated.
+static inline int generate_int_data(int* arr, size_t n, int max_value, DataDistribution dist, uint64_t seed) {
+    Xoshiro256 rng;
+    xoshiro_seed(&rng, seed);
+    if (n == 0) return 1;
+
+    switch (dist) {
+    case DIST_UNIFORM:
+        for (size_t i = 0; i < n; i++) arr[i] = (int)xoshiro_below(&rng, (uint64_t)max_value + 1);
+        break;
+
+    case DIST_SORTED:
+    case DIST_REVERSE:
+    case DIST_NEARLY_SORTED:
+        for (size_t i = 0; i < n; i++) {
+            size_t pos = dist == DIST_REVERSE ? n - 1 - i : i;
+            arr[i] = data_gen_scale(pos, n, max_value);
+        }
+        if (dist == DIST_NEARLY_SORTED) {
+            size_t swaps = n / 100 > 0 ? n / 100 : 1;
+            for (size_t k = 0; k < swaps; k++) {
+                size_t a = (size_t)xoshiro_below(&rng, n);
+                size_t b = (size_t)xoshiro_below(&rng, n);
+                int t = arr[a]; arr[a] = arr[b]; arr[b] = t;
+            }
+        }
+        break;
+
+    case DIST_FEW_UNIQUE: {
+        int step = max_value / (DATA_GEN_FEW_UNIQUE - 1);
+        for (size_t i = 0; i < n; i++) arr[i] = (int)xoshiro_below(&rng, DATA_GEN_FEW_UNIQUE) * step;
+        break;
+    }
+
+    case DIST_ORGAN_PIPE: {
+        size_t half = (n + 1) / 2;
+        for (size_t i = 0; i < n; i++) {
+            size_t pos = i < half ? i : n - 1 - i;
+            arr[i] = data_gen_scale(pos, half, max_value);
+        }
+        break;
+    }
+
+    case DIST_SAWTOOTH: {
+        size_t period = n / DATA_GEN_SAWTOOTH_TEETH > 0 ? n / DATA_GEN_SAWTOOTH_TEETH : 1;
+        for (size_t i = 0; i < n; i++) arr[i] = data_gen_scale(i % period, period, max_value);
+        break;
+    }
+
+    case DIST_ZIPF: {
+        // Rank r (1-based) has weight 1 / r^s; sample by binary search over the CDF table
+        size_t ranks = (size_t)max_value + 1 < DATA_GEN_ZIPF_MAX_RANKS ? (size_t)max_value + 1 : DATA_GEN_ZIPF_MAX_RANKS;
+        double* cdf = (double*)malloc(sizeof(double) * ranks);
+        if (!cdf) return 0;
+        double total = 0.0;
+        for (size_t r = 0; r < ranks; r++) {
+            total += 1.0 / pow((double)(r + 1), DATA_GEN_ZIPF_EXPONENT);
+            cdf[r] = total;
+        }
+
+        // Ranks are spread over [0, max_value] so frequent values are not all the smallest
+        uint64_t stride = ranks > 1 ? (uint64_t)max_value / (ranks - 1) : 0;
+        for (size_t i = 0; i < n; i++) {
+            double u = xoshiro_double(&rng) * total;
+            size_t lo = 0, hi = ranks - 1;
+            while (lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (cdf[mid] <= u) lo = mid + 1;
+                else hi = mid;
+            }
+            arr[i] = (int)((lo * 0x9E3779B1u % ranks) * stride);
+        }
+        free(cdf);
+        break;
+    }
+
+    default:
+        return 0;
+    }
+    return 1;
+}
+
+#endif // DATA_GENERATOR_H
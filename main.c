@@ -4,15 +4,31 @@
 #include <time.h>
 #include <locale.h>
 
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <unistd.h>
+#define HAVE_PTHREADS 1
+#else
+#define HAVE_PTHREADS 0
+#endif
+
+#include "sort_network.h"
+#include "data_generator.h"
+#include "shell_gaps.h"
+
 #define DATA_SIZE 10000
 #define MAX_VAL 1000000
-#define MAX_VAL_MODULO (MAX_VAL + 1)
 #define NUM_TRIALS 100
+#define DEFAULT_SEED 20240601ull // Trial i uses seed + i
+#define PARALLEL_CHAIN_MIN_GAP 1024 // Smaller gaps leave too little work per chain for a thread
+#define MAX_CHAIN_THREADS 64
 
-void generate_data(int* arr) {
-    for (int i = 0; i < DATA_SIZE; i++) {
-        arr[i] = rand() % MAX_VAL_MODULO;
-    }
+int chain_threads = 0; // Threads sorting h-chains of one pass in parallel (0 = all online CPUs)
+size_t custom_gaps[SHELL_MAX_GAPS]; // -g list for shell_custom
+int custom_gap_count = 0;
+
+int generate_data(int* arr, int n, DataDistribution dist, uint64_t seed) {
+    return generate_int_data(arr, (size_t)n, MAX_VAL, dist, seed);
 }
 
 long long insertion_sort(int* arr, int n) {
@@ -61,19 +77,33 @@ long long shell_sort_basic(int* arr, int n) {
     return comparisons;
 }
 
-long long shell_sort_ciura(int* arr, int n) {
-    long long comparisons = 0;
+// --- Shell sort gap-sequence engine ---
+// A pass with gap h sorts h independent chains (r, r + h, r + 2h, ...). The residues
+// [r0, r1) of a pass are walked row by row (base + r0 .. base + r1 for base = h, 2h, ...),
+// which inserts every element of every chain in increasing index order, so the result and
+// comparison count match the usual i = h .. n - 1 loop. Large gaps split the residues
+// across threads; each thread only touches its own chains.
 
-    int gaps[] = { 8859, 3937, 1750, 701, 301, 132, 57, 23, 10, 4, 1 };
-    int num_gaps = sizeof(gaps) / sizeof(gaps[0]);
+typedef struct {
+    int* arr;
+    size_t n;
+    size_t gap;
+    size_t r0;
+    size_t r1;
+    long long comparisons;
+} ChainTask;
 
-    for (int k = 0; k < num_gaps; k++) {
-        int gap = gaps[k];
-        if (gap >= n) continue;
+void h_sort_chains(ChainTask* task) {
+    int* arr = task->arr;
+    size_t n = task->n;
+    size_t gap = task->gap;
+    long long comparisons = 0;
 
-        for (int i = gap; i < n; i++) {
+    for (size_t base = gap; base + task->r0 < n; base += gap) {
+        size_t end = (base + task->r1 < n) ? base + task->r1 : n;
+        for (size_t i = base + task->r0; i < end; i++) {
             int temp = arr[i];
-            int j;
+            size_t j;
 
             for (j = i; j >= gap; j -= gap) {
                 comparisons++;
@@ -87,52 +117,384 @@ long long shell_sort_ciura(int* arr, int n) {
             arr[j] = temp;
         }
     }
+    task->comparisons = comparisons;
+}
+
+#if HAVE_PTHREADS
+void* chain_task_main(void* arg) {
+    h_sort_chains((ChainTask*)arg);
+    return NULL;
+}
+#endif
+
+int resolve_chain_threads(void) {
+    int threads = chain_threads;
+#if HAVE_PTHREADS
+    if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#else
+    threads = 1;
+#endif
+    if (threads < 1) threads = 1;
+    if (threads > MAX_CHAIN_THREADS) threads = MAX_CHAIN_THREADS;
+    return threads;
+}
+
+// One h-sorting pass, split over threads when the gap is large
+long long h_sort_pass(int* arr, int n, size_t gap) {
+    int threads = resolve_chain_threads();
+    if (gap < PARALLEL_CHAIN_MIN_GAP || threads == 1) {
+        ChainTask task = { arr, (size_t)n, gap, 0, gap, 0 };
+        h_sort_chains(&task);
+        return task.comparisons;
+    }
+    if ((size_t)threads > gap) threads = (int)gap;
+
+    ChainTask tasks[MAX_CHAIN_THREADS];
+    for (int t = 0; t < threads; t++) {
+        ChainTask task = { arr, (size_t)n, gap, gap * t / threads, gap * (t + 1) / threads, 0 };
+        tasks[t] = task;
+    }
+
+    long long comparisons = 0;
+#if HAVE_PTHREADS
+    pthread_t handles[MAX_CHAIN_THREADS];
+    int started[MAX_CHAIN_THREADS] = { 0 };
+    for (int t = 1; t < threads; t++) {
+        started[t] = pthread_create(&handles[t], NULL, chain_task_main, &tasks[t]) == 0;
+    }
+    h_sort_chains(&tasks[0]);
+    for (int t = 1; t < threads; t++) {
+        if (started[t]) pthread_join(handles[t], NULL);
+        else h_sort_chains(&tasks[t]); // Could not spawn: sort these chains here
+    }
+#else
+    for (int t = 0; t < threads; t++) h_sort_chains(&tasks[t]);
+#endif
+    for (int t = 0; t < threads; t++) comparisons += tasks[t].comparisons;
     return comparisons;
 }
 
-int main() {
-    srand((unsigned int)time(NULL));
+// Runs one pass per gap; gaps are descending and the ones >= n are skipped
+long long shell_sort_gaps(int* arr, int n, const size_t* gaps, int gap_count) {
+    long long comparisons = 0;
+    for (int k = shell_gaps_first_below(gaps, gap_count, (size_t)n); k < gap_count; k++) {
+        comparisons += h_sort_pass(arr, n, gaps[k]);
+    }
+    return comparisons;
+}
 
-    setlocale(LC_NUMERIC, "");
+long long shell_sort_sequence(int* arr, int n, GapSequence seq) {
+    size_t gaps[SHELL_MAX_GAPS];
+    int gap_count = shell_gaps_generate(seq, (size_t)n, gaps);
+    return shell_sort_gaps(arr, n, gaps, gap_count);
+}
 
-    long long total_insertion_comps = 0;
-    long long total_shell_basic_comps = 0;
-    long long total_shell_ciura_comps = 0;
+// Ciura's gaps up to 8859, extended by x2.25 beyond it for large n
+long long shell_sort_ciura(int* arr, int n) {
+    return shell_sort_sequence(arr, n, GAPS_CIURA);
+}
+
+long long shell_sort_knuth(int* arr, int n) {
+    return shell_sort_sequence(arr, n, GAPS_KNUTH);
+}
+
+long long shell_sort_tokuda(int* arr, int n) {
+    return shell_sort_sequence(arr, n, GAPS_TOKUDA);
+}
+
+long long shell_sort_sedgewick(int* arr, int n) {
+    return shell_sort_sequence(arr, n, GAPS_SEDGEWICK);
+}
 
-    int original_data[DATA_SIZE];
-    int data_insertion[DATA_SIZE];
-    int data_shell_basic[DATA_SIZE];
-    int data_shell_ciura[DATA_SIZE];
+long long shell_sort_pratt(int* arr, int n) {
+    return shell_sort_sequence(arr, n, GAPS_PRATT);
+}
 
-    printf("데이터 크기: %d, 실행 횟수: %d\n", DATA_SIZE, NUM_TRIALS);
-    printf("----------------------------------------\n");
-    fflush(stdout);
+long long shell_sort_custom(int* arr, int n) {
+    return shell_sort_gaps(arr, n, custom_gaps, custom_gap_count);
+}
 
-    for (int i = 0; i < NUM_TRIALS; i++) {
-        generate_data(original_data);
+// Blocks of SORT_NETWORK_MAX_INTS are sorted by a bitonic network (AVX2 if the CPU has it),
+// then merged bottom-up. Network comparisons count every compare-exchange in the network.
+long long network_merge_sort(int* arr, int n) {
+    long long comparisons = 0;
 
-        memcpy(data_insertion, original_data, sizeof(original_data));
-        memcpy(data_shell_basic, original_data, sizeof(original_data));
-        memcpy(data_shell_ciura, original_data, sizeof(original_data));
+    for (int l = 0; l < n; l += SORT_NETWORK_MAX_INTS) {
+        int len = (n - l < SORT_NETWORK_MAX_INTS) ? n - l : SORT_NETWORK_MAX_INTS;
+        comparisons += sort_network_int32(arr + l, len);
+    }
 
-        total_insertion_comps += insertion_sort(data_insertion, DATA_SIZE);
-        total_shell_basic_comps += shell_sort_basic(data_shell_basic, DATA_SIZE);
-        total_shell_ciura_comps += shell_sort_ciura(data_shell_ciura, DATA_SIZE);
+    int* temp = (int*)malloc(sizeof(int) * n);
+    if (!temp) {
+        fprintf(stderr, "Error: Memory allocation failed for network merge sort.\n");
+        return comparisons;
+    }
 
-        if ((i + 1) % 10 == 0) {
-            printf("진행 중... (%d/%d)\n", i + 1, NUM_TRIALS);
-            fflush(stdout);
+    int* src = arr;
+    int* dst = temp;
+    for (int width = SORT_NETWORK_MAX_INTS; width < n; width *= 2) {
+        for (int l = 0; l < n; l += 2 * width) {
+            int m = (l + width < n) ? l + width : n;
+            int r = (l + 2 * width < n) ? l + 2 * width : n;
+            int i = l, j = m, k = l;
+
+            while (i < m && j < r) {
+                comparisons++;
+                if (src[i] <= src[j]) dst[k++] = src[i++];
+                else dst[k++] = src[j++];
+            }
+            while (i < m) dst[k++] = src[i++];
+            while (j < r) dst[k++] = src[j++];
+        }
+        int* t = src; src = dst; dst = t;
+    }
+    if (src != arr) memcpy(arr, src, sizeof(int) * n);
+
+    free(temp);
+    return comparisons;
+}
+
+typedef long long (*IntSortFunc)(int*, int);
+
+typedef struct {
+    const char* id;    // Name in CSV output
+    const char* label; // Name in the text report
+    IntSortFunc sort;
+} IntSortEntry;
+
+const IntSortEntry int_sorts[] = {
+    { "insertion", "1. 단순 삽입 정렬    ", insertion_sort },
+    { "shell_basic", "2. 기본 쉘 정렬 (N/2)", shell_sort_basic },
+    { "shell_ciura", "3. Ciura 간격 쉘 정렬", shell_sort_ciura },
+    { "network_merge", "4. 정렬 네트워크+병합", network_merge_sort },
+    { "shell_knuth", "5. Knuth 간격 쉘 정렬", shell_sort_knuth },
+    { "shell_tokuda", "6. Tokuda 간격 쉘 정렬", shell_sort_tokuda },
+    { "shell_sedgewick", "7. Sedgewick 간격 쉘", shell_sort_sedgewick },
+    { "shell_pratt", "8. Pratt 간격 쉘 정렬", shell_sort_pratt },
+    { "shell_custom", "9. 사용자 간격 쉘 정렬", shell_sort_custom },
+};
+
+#define INT_SORT_COUNT ((int)(sizeof(int_sorts) / sizeof(int_sorts[0])))
+
+void print_usage(FILE* out) {
+    fprintf(out, "Usage: main [-n SIZE] [-t TRIALS] [-d DIST] [-s SEED] [-a LIST] [-g GAPS] [-j THREADS] [-f text|csv]\n");
+    fprintf(out, "  -n SIZE    data size (default %d, 1e6 style accepted)\n", DATA_SIZE);
+    fprintf(out, "  -t TRIALS  number of trials (default %d)\n", NUM_TRIALS);
+    fprintf(out, "  -d DIST    input distribution or 'all' (default uniform):");
+    for (int d = 0; d < DIST_COUNT; d++) fprintf(out, " %s", data_distribution_names[d]);
+    fprintf(out, "\n");
+    fprintf(out, "  -s SEED    PRNG seed; trial i uses SEED + i (default %llu)\n", (unsigned long long)DEFAULT_SEED);
+    fprintf(out, "  -a LIST    algorithms to run, comma separated (default all):");
+    for (int a = 0; a < INT_SORT_COUNT; a++) fprintf(out, " %s", int_sorts[a].id);
+    fprintf(out, "\n");
+    fprintf(out, "  -g GAPS    custom gap list for shell_custom, e.g. 701,301,132,57,23,10,4,1\n");
+    fprintf(out, "  -j THREADS threads for the h-chains of gaps >= %d (default 0 = all CPUs)\n", PARALLEL_CHAIN_MIN_GAP);
+    fprintf(out, "  -f FORMAT  text (default) or csv: one row per algorithm\n");
+}
+
+int parse_positive(const char* text, int* out) {
+    char* end;
+    double value = strtod(text, &end);
+    if (end == text || *end != '\0' || value < 1 || value > 2147483647.0 || value != (double)(int)value) {
+        fprintf(stderr, "Error: Invalid number '%s'.\n", text);
+        return 0;
+    }
+    *out = (int)value;
+    return 1;
+}
+
+// Enables the algorithms named in a comma-separated list; 0 on an unknown name
+int select_algorithms(const char* list, int enabled[]) {
+    for (int a = 0; a < INT_SORT_COUNT; a++) enabled[a] = 0;
+
+    const char* p = list;
+    while (1) {
+        const char* comma = strchr(p, ',');
+        size_t len = comma ? (size_t)(comma - p) : strlen(p);
+        int found = 0;
+        for (int a = 0; a < INT_SORT_COUNT; a++) {
+            if (strlen(int_sorts[a].id) == len && strncmp(int_sorts[a].id, p, len) == 0) {
+                enabled[a] = 1;
+                found = 1;
+            }
+        }
+        if (!found) {
+            fprintf(stderr, "Error: Unknown algorithm '%.*s'.\n", (int)len, p);
+            return 0;
+        }
+        if (!comma) return 1;
+        p = comma + 1;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int data_size = DATA_SIZE;
+    int num_trials = NUM_TRIALS;
+    int csv = 0;
+    int first_dist = DIST_UNIFORM;
+    int last_dist = DIST_UNIFORM;
+    uint64_t seed = DEFAULT_SEED;
+    int enabled[INT_SORT_COUNT];
+    int selected = 0; // 1 once -a chose the algorithms
+    int custom_index = -1;
+    for (int a = 0; a < INT_SORT_COUNT; a++) {
+        enabled[a] = 1;
+        if (int_sorts[a].sort == shell_sort_custom) custom_index = a;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(stdout);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            print_usage(stderr);
+            return 1;
+        }
+        if (strcmp(argv[i], "-n") == 0) {
+            if (!parse_positive(argv[++i], &data_size)) return 1;
+        }
+        else if (strcmp(argv[i], "-t") == 0) {
+            if (!parse_positive(argv[++i], &num_trials)) return 1;
+        }
+        else if (strcmp(argv[i], "-d") == 0) {
+            i++;
+            if (strcmp(argv[i], "all") == 0) {
+                first_dist = 0;
+                last_dist = DIST_COUNT - 1;
+            }
+            else if ((first_dist = data_distribution_from_name(argv[i])) >= 0) {
+                last_dist = first_dist;
+            }
+            else {
+                fprintf(stderr, "Error: Unknown distribution '%s'.\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-s") == 0) {
+            char* end;
+            seed = strtoull(argv[++i], &end, 0);
+            if (*end != '\0') {
+                fprintf(stderr, "Error: Invalid seed '%s'.\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-a") == 0) {
+            if (!select_algorithms(argv[++i], enabled)) return 1;
+            selected = 1;
+        }
+        else if (strcmp(argv[i], "-g") == 0) {
+            custom_gap_count = shell_gaps_parse(argv[++i], custom_gaps);
+            if (custom_gap_count < 0) {
+                fprintf(stderr, "Error: Invalid gap list '%s'.\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-j") == 0) {
+            char* end;
+            long threads = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || threads < 0 || threads > MAX_CHAIN_THREADS) {
+                fprintf(stderr, "Error: Thread count must be between 0 and %d.\n", MAX_CHAIN_THREADS);
+                return 1;
+            }
+            chain_threads = (int)threads;
         }
+        else if (strcmp(argv[i], "-f") == 0) {
+            i++;
+            if (strcmp(argv[i], "csv") == 0) csv = 1;
+            else if (strcmp(argv[i], "text") != 0) {
+                print_usage(stderr);
+                return 1;
+            }
+        }
+        else {
+            print_usage(stderr);
+            return 1;
+        }
+    }
+
+    if (custom_gap_count == 0 && custom_index >= 0 && enabled[custom_index]) {
+        if (selected) {
+            fprintf(stderr, "Error: shell_custom requires a gap list (-g GAPS).\n");
+            return 1;
+        }
+        enabled[custom_index] = 0; // shell_custom only runs with -g
+    }
+
+    setlocale(LC_NUMERIC, "");
+
+    // Heap buffers: the data size is only known at run time
+    size_t bytes = sizeof(int) * (size_t)data_size;
+    int* original_data = (int*)malloc(bytes);
+    int* data = (int*)malloc(bytes);
+    if (!original_data || !data) {
+        fprintf(stderr, "Error: Memory allocation failed for %d elements.\n", data_size);
+        free(original_data);
+        free(data);
+        return 1;
     }
 
-    double avg_insertion = (double)total_insertion_comps / NUM_TRIALS;
-    double avg_shell_basic = (double)total_shell_basic_comps / NUM_TRIALS;
-    double avg_shell_ciura = (double)total_shell_ciura_comps / NUM_TRIALS;
+    if (csv) {
+        printf("algorithm,distribution,n,trials,seed,avg_comparisons,avg_time_ms\n");
+    }
+    else {
+        printf("데이터 크기: %d, 실행 횟수: %d, 시드: %llu\n", data_size, num_trials, (unsigned long long)seed);
+        printf("정렬 네트워크: %s, h-체인 스레드: %d\n", sort_network_has_avx2() ? "AVX2" : "스칼라", resolve_chain_threads());
+    }
+
+    for (int dist = first_dist; dist <= last_dist; dist++) {
+        long long total_comps[INT_SORT_COUNT] = { 0 }; // 64-bit: insertion sort at 10^8 needs ~2.5 * 10^15
+        double total_ms[INT_SORT_COUNT] = { 0 };
+
+        if (!csv) {
+            printf("----------------------------------------\n");
+            printf("분포: %s\n", data_distribution_names[dist]);
+            fflush(stdout);
+        }
+
+        for (int i = 0; i < num_trials; i++) {
+            if (!generate_data(original_data, data_size, (DataDistribution)dist, seed + (uint64_t)i)) {
+                fprintf(stderr, "Error: Could not generate %s data.\n", data_distribution_names[dist]);
+                free(original_data);
+                free(data);
+                return 1;
+            }
+
+            for (int a = 0; a < INT_SORT_COUNT; a++) {
+                if (!enabled[a]) continue;
+                memcpy(data, original_data, bytes);
+                struct timespec start, end;
+                timespec_get(&start, TIME_UTC);
+                total_comps[a] += int_sorts[a].sort(data, data_size);
+                timespec_get(&end, TIME_UTC);
+                total_ms[a] += (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+            }
+
+            if (!csv && (i + 1) % 10 == 0) {
+                printf("진행 중... (%d/%d)\n", i + 1, num_trials);
+                fflush(stdout);
+            }
+        }
 
-    printf("\n--- 최종 결과 (100회 평균 비교 횟수) ---\n");
-    printf("%-22s: %'15.0f 회\n", "1. 단순 삽입 정렬    ", avg_insertion);
-    printf("%-22s: %'15.0f 회\n", "2. 기본 쉘 정렬 (N/2)", avg_shell_basic);
-    printf("%-22s: %'15.0f 회\n", "3. Ciura 간격 쉘 정렬", avg_shell_ciura);
+        if (csv) {
+            for (int a = 0; a < INT_SORT_COUNT; a++) {
+                if (!enabled[a]) continue;
+                printf("%s,%s,%d,%d,%llu,%.0f,%.3f\n", int_sorts[a].id, data_distribution_names[dist], data_size, num_trials,
+                    (unsigned long long)seed, (double)total_comps[a] / num_trials, total_ms[a] / num_trials);
+            }
+        }
+        else {
+            printf("\n--- 최종 결과 (%d회 평균 비교 횟수 / 시간, %s) ---\n", num_trials, data_distribution_names[dist]);
+            for (int a = 0; a < INT_SORT_COUNT; a++) {
+                if (!enabled[a]) continue;
+                printf("%-22s: %'15.0f 회 %'12.3f ms\n", int_sorts[a].label, (double)total_comps[a] / num_trials,
+                    total_ms[a] / num_trials);
+            }
+        }
+        fflush(stdout);
+    }
 
+    free(original_data);
+    free(data);
     return 0;
 }
\ No newline at end of file
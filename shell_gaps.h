@@ -0,0 +1,156 @@
+// shell_gaps.h - Gap sequences for Shell sort
+//
+// Shared by main.c (int arrays, parallel h-chains) and sorting_assignment.c (Student
+// records). Every generator writes the gaps smaller than n in descending order, ending
+// with 1, so a Shell sort simply runs one h-sorting pass per entry.
+
+#ifndef SHELL_GAPS_H
+#define SHELL_GAPS_H
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SHELL_MAX_GAPS 512 // Pratt's sequence for n = 2^31 has 328 gaps
+
+typedef enum {
+    GAPS_HALVING,   // n/2, n/4, ..., 1 (Shell 1959)
+    GAPS_KNUTH,     // (3^k - 1) / 2: 1, 4, 13, 40, ...
+    GAPS_CIURA,     // Ciura 2001 up to 1750, then the 3937, 8859 tail extended by x2.25
+    GAPS_TOKUDA,    // ceil((9^k - 4^k) / (5 * 4^(k-1))): 1, 4, 9, 20, 46, ...
+    GAPS_SEDGEWICK, // Sedgewick 1986: 1, 8, 23, 77, 281, ... (4^k + 3 * 2^(k-1) + 1)
+    GAPS_PRATT,     // All 2^p * 3^q: 1, 2, 3, 4, 6, 8, 9, 12, ... (Theta(n log^2 n) worst case)
+    GAPS_COUNT
+} GapSequence;
+
+static const char* const gap_sequence_names[GAPS_COUNT] = {
+    "halving", "knuth", "ciura", "tokuda", "sedgewick", "pratt"
+};
+
+// Reverses gaps[0, count) and returns count (generators build the sequence ascending)
+static inline int shell_gaps_descending(size_t gaps[], int count) {
+    for (int i = 0, j = count - 1; i < j; i++, j--) {
+        size_t t = gaps[i]; gaps[i] = gaps[j]; gaps[j] = t;
+    }
+    return count;
+}
+
+static int shell_gaps_compare_size(const void* a, const void* b) {
+    size_t x = *(const size_t*)a;
+    size_t y = *(const size_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Writes the gaps of seq below n into gaps[] (descending, ending with 1) and returns their
+// count; at most SHELL_MAX_GAPS entries are written.
+static inline int shell_gaps_generate(GapSequence seq, size_t n, size_t gaps[]) {
+    int count = 0;
+    if (n < 2) return 0;
+
+    switch (seq) {
+    case GAPS_HALVING:
+        for (size_t h = n / 2; h > 0 && count < SHELL_MAX_GAPS; h /= 2) gaps[count++] = h;
+        return count; // Already descending
+
+    case GAPS_KNUTH:
+        for (size_t h = 1; h < n && count < SHELL_MAX_GAPS; h = h * 3 + 1) gaps[count++] = h;
+        break;
+
+    case GAPS_CIURA: {
+        static const size_t ciura[] = { 1, 4, 10, 23, 57, 132, 301, 701, 1750, 3937, 8859 };
+        size_t h = 0;
+        for (size_t i = 0; i < sizeof(ciura) / sizeof(ciura[0]) && ciura[i] < n; i++) {
+            h = ciura[i];
+            gaps[count++] = h;
+        }
+        if (h == 8859) {
+            for (h = (size_t)(h * 2.25); h < n && count < SHELL_MAX_GAPS; h = (size_t)(h * 2.25)) gaps[count++] = h;
+        }
+        break;
+    }
+
+    case GAPS_TOKUDA: {
+        // h_k = ceil(h'_k) with h'_1 = 1 and h'_(k+1) = 2.25 * h'_k + 1
+        double exact = 1.0;
+        for (size_t h = 1; h < n && count < SHELL_MAX_GAPS;) {
+            gaps[count++] = h;
+            exact = 2.25 * exact + 1.0;
+            size_t next = (size_t)exact;
+            h = (double)next < exact ? next + 1 : next;
+        }
+        break;
+    }
+
+    case GAPS_SEDGEWICK:
+        gaps[count++] = 1;
+        for (int k = 1; count < SHELL_MAX_GAPS && 2 * k < (int)(sizeof(size_t) * 8) - 1; k++) {
+            size_t h = ((size_t)1 << (2 * k)) + 3 * ((size_t)1 << (k - 1)) + 1;
+            if (h >= n) break;
+            gaps[count++] = h;
+        }
+        break;
+
+    case GAPS_PRATT:
+        for (size_t p2 = 1; p2 < n; p2 *= 2) {
+            for (size_t h = p2; h < n && count < SHELL_MAX_GAPS; h *= 3) gaps[count++] = h;
+            if (p2 > n / 2) break;
+        }
+        qsort(gaps, (size_t)count, sizeof(size_t), shell_gaps_compare_size);
+        break;
+
+    default:
+        return 0;
+    }
+    return shell_gaps_descending(gaps, count);
+}
+
+// Index of the named sequence, or -1
+static inline int gap_sequence_from_name(const char* name) {
+    for (int i = 0; i < GAPS_COUNT; i++) {
+        if (strcmp(name, gap_sequence_names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+// Parses a custom comma-separated list ("701,301,132,57,23,10,4,1") into descending,
+// de-duplicated gaps, adding the final 1 if it is missing. Returns the count, or -1 if
+// the list is malformed: every item must be a positive decimal number (no sign, spaces or
+// empty items, which strtoull alone would accept or skip).
+static inline int shell_gaps_parse(const char* list, size_t gaps[]) {
+    int count = 0;
+    const char* p = list;
+    while (1) {
+        if (*p < '0' || *p > '9') return -1;
+        char* end;
+        errno = 0;
+        unsigned long long h = strtoull(p, &end, 10);
+        if (errno == ERANGE || h == 0 || h > SIZE_MAX || count >= SHELL_MAX_GAPS - 1) return -1;
+        gaps[count++] = (size_t)h;
+        if (*end == '\0') break;
+        if (*end != ',') return -1;
+        p = end + 1;
+    }
+
+    qsort(gaps, (size_t)count, sizeof(size_t), shell_gaps_compare_size);
+    int unique = 0;
+    for (int i = 0; i < count; i++) {
+        if (unique == 0 || gaps[i] != gaps[unique - 1]) gaps[unique++] = gaps[i];
+    }
+    if (unique == 0 || gaps[0] != 1) {
+        memmove(gaps + 1, gaps, sizeof(size_t) * (size_t)unique);
+        gaps[0] = 1;
+        unique++;
+    }
+    return shell_gaps_descending(gaps, unique);
+}
+
+// Drops the gaps >= n from a descending list; returns the offset of the first usable gap
+static inline int shell_gaps_first_below(const size_t gaps[], int count, size_t n) {
+    int first = 0;
+    while (first < count && gaps[first] >= n) first++;
+    return first;
+}
+
+#endif // SHELL_GAPS_H
@@ -0,0 +1,232 @@
+// sort_network.h - Bitonic sorting networks for small blocks of integers
+//
+// Shared by main.c (int arrays) and sorting_assignment.c (packed key+index pairs) as the
+// base case of their merge sorts. A block is padded to a power of two with the largest
+// value and sorted by a fixed bitonic network: no data-dependent branches, so it does not
+// pay for branch mispredictions the way insertion sort does on random input.
+//
+// On x86 with GCC/Clang, an AVX2 version is compiled with a function-level target
+// attribute and picked at run time with __builtin_cpu_supports, so the program still
+// runs on CPUs without AVX2. Everywhere else the scalar network is used.
+
+#ifndef SORT_NETWORK_H
+#define SORT_NETWORK_H
+
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SORT_NETWORK_HAVE_AVX2 1
+#define SORT_NETWORK_AVX2 __attribute__((target("avx2")))
+#else
+#define SORT_NETWORK_HAVE_AVX2 0
+#endif
+
+#define SORT_NETWORK_MAX_INTS 64  // Largest int32 block (8 AVX2 registers of 8 lanes)
+#define SORT_NETWORK_MAX_PAIRS 32 // Largest packed 64-bit block (8 AVX2 registers of 4 lanes)
+
+// Smallest power of two >= n and >= min_size
+static inline int sort_network_padded_size(int n, int min_size) {
+    int size = min_size;
+    while (size < n) size <<= 1;
+    return size;
+}
+
+// Compare-exchange operations in a bitonic network of n = 2^L inputs: (n / 2) * L * (L + 1) / 2.
+// Reported as the comparison count of a network sort, whichever implementation runs.
+static inline long long sort_network_comparators(int n) {
+    int levels = 0;
+    while ((1 << levels) < n) levels++;
+    return (long long)(n / 2) * levels * (levels + 1) / 2;
+}
+
+// --- Scalar networks ---
+
+static inline void bitonic_sort_int32_scalar(int32_t a[], int n) {
+    for (int k = 2; k <= n; k <<= 1) {
+        for (int j = k >> 1; j > 0; j >>= 1) {
+            for (int i = 0; i < n; i++) {
+                int l = i ^ j;
+                if (l <= i) continue;
+                int ascending = (i & k) == 0;
+                if (ascending ? a[i] > a[l] : a[i] < a[l]) {
+                    int32_t t = a[i]; a[i] = a[l]; a[l] = t;
+                }
+            }
+        }
+    }
+}
+
+static inline void bitonic_sort_u64_scalar(uint64_t a[], int n) {
+    for (int k = 2; k <= n; k <<= 1) {
+        for (int j = k >> 1; j > 0; j >>= 1) {
+            for (int i = 0; i < n; i++) {
+                int l = i ^ j;
+                if (l <= i) continue;
+                int ascending = (i & k) == 0;
+                if (ascending ? a[i] > a[l] : a[i] < a[l]) {
+                    uint64_t t = a[i]; a[i] = a[l]; a[l] = t;
+                }
+            }
+        }
+    }
+}
+
+#if SORT_NETWORK_HAVE_AVX2
+
+// --- AVX2 networks ---
+// Stages with a partner distance of at least one register compare whole registers with
+// min/max. Shorter distances pair lanes inside a register through a shuffle, and a blend
+// picks min or max per lane from the lane's position in the pair and in the bitonic block.
+
+static inline SORT_NETWORK_AVX2 __m256i bitonic_partner_epi32(__m256i x, int j) {
+    switch (j) {
+    case 4: return _mm256_permute2x128_si256(x, x, 0x01);
+    case 2: return _mm256_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2));
+    default: return _mm256_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1));
+    }
+}
+
+// n is a power of two between 8 and SORT_NETWORK_MAX_INTS
+static SORT_NETWORK_AVX2 void bitonic_sort_int32_avx2(int32_t a[], int n) {
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    for (int k = 2; k <= n; k <<= 1) {
+        for (int j = k >> 1; j > 0; j >>= 1) {
+            if (j >= 8) {
+                for (int i = 0; i < n; i += 8) {
+                    if (i & j) continue;
+                    __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+                    __m256i y = _mm256_loadu_si256((const __m256i*)(a + i + j));
+                    __m256i lo = _mm256_min_epi32(x, y);
+                    __m256i hi = _mm256_max_epi32(x, y);
+                    int ascending = (i & k) == 0;
+                    _mm256_storeu_si256((__m256i*)(a + i), ascending ? lo : hi);
+                    _mm256_storeu_si256((__m256i*)(a + i + j), ascending ? hi : lo);
+                }
+                continue;
+            }
+
+            const __m256i bit_j = _mm256_set1_epi32(j);
+            const __m256i bit_k = _mm256_set1_epi32(k);
+            for (int i = 0; i < n; i += 8) {
+                __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+                __m256i p = bitonic_partner_epi32(x, j);
+                __m256i lo = _mm256_min_epi32(x, p);
+                __m256i hi = _mm256_max_epi32(x, p);
+
+                // The upper lane of an ascending pair (or the lower of a descending one) keeps the max
+                __m256i idx = _mm256_add_epi32(lane, _mm256_set1_epi32(i));
+                __m256i upper = _mm256_cmpeq_epi32(_mm256_and_si256(idx, bit_j), bit_j);
+                __m256i descending = _mm256_cmpeq_epi32(_mm256_and_si256(idx, bit_k), bit_k);
+                __m256i take_hi = _mm256_xor_si256(upper, descending);
+                _mm256_storeu_si256((__m256i*)(a + i), _mm256_blendv_epi8(lo, hi, take_hi));
+            }
+        }
+    }
+}
+
+// AVX2 has no unsigned 64-bit compare: flip the sign bits and compare as signed
+static inline SORT_NETWORK_AVX2 void bitonic_minmax_u64(__m256i x, __m256i y, __m256i* lo, __m256i* hi) {
+    const __m256i bias = _mm256_set1_epi64x(INT64_MIN);
+    __m256i gt = _mm256_cmpgt_epi64(_mm256_xor_si256(x, bias), _mm256_xor_si256(y, bias));
+    *lo = _mm256_blendv_epi8(x, y, gt);
+    *hi = _mm256_blendv_epi8(y, x, gt);
+}
+
+// n is a power of two between 4 and SORT_NETWORK_MAX_PAIRS
+static SORT_NETWORK_AVX2 void bitonic_sort_u64_avx2(uint64_t a[], int n) {
+    const __m256i lane = _mm256_setr_epi64x(0, 1, 2, 3);
+
+    for (int k = 2; k <= n; k <<= 1) {
+        for (int j = k >> 1; j > 0; j >>= 1) {
+            if (j >= 4) {
+                for (int i = 0; i < n; i += 4) {
+                    if (i & j) continue;
+                    __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+                    __m256i y = _mm256_loadu_si256((const __m256i*)(a + i + j));
+                    __m256i lo, hi;
+                    bitonic_minmax_u64(x, y, &lo, &hi);
+                    int ascending = (i & k) == 0;
+                    _mm256_storeu_si256((__m256i*)(a + i), ascending ? lo : hi);
+                    _mm256_storeu_si256((__m256i*)(a + i + j), ascending ? hi : lo);
+                }
+                continue;
+            }
+
+            const __m256i bit_j = _mm256_set1_epi64x(j);
+            const __m256i bit_k = _mm256_set1_epi64x(k);
+            for (int i = 0; i < n; i += 4) {
+                __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+                __m256i p = j == 2 ? _mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 3, 2))
+                                   : _mm256_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2));
+                __m256i lo, hi;
+                bitonic_minmax_u64(x, p, &lo, &hi);
+
+                __m256i idx = _mm256_add_epi64(lane, _mm256_set1_epi64x(i));
+                __m256i upper = _mm256_cmpeq_epi64(_mm256_and_si256(idx, bit_j), bit_j);
+                __m256i descending = _mm256_cmpeq_epi64(_mm256_and_si256(idx, bit_k), bit_k);
+                __m256i take_hi = _mm256_xor_si256(upper, descending);
+                _mm256_storeu_si256((__m256i*)(a + i), _mm256_blendv_epi8(lo, hi, take_hi));
+            }
+        }
+    }
+}
+
+#endif // SORT_NETWORK_HAVE_AVX2
+
+// 1 if the AVX2 networks can run on this CPU
+static inline int sort_network_has_avx2(void) {
+#if SORT_NETWORK_HAVE_AVX2
+    return __builtin_cpu_supports("avx2") != 0;
+#else
+    return 0;
+#endif
+}
+
+// --- Entry points ---
+
+// Sorts a[0, n) ascending for n <= SORT_NETWORK_MAX_INTS. Returns the comparator count.
+static inline long long sort_network_int32(int32_t a[], int n) {
+    if (n < 2) return 0;
+
+    int32_t block[SORT_NETWORK_MAX_INTS];
+    int size = sort_network_padded_size(n, 8);
+    memcpy(block, a, sizeof(int32_t) * n);
+    for (int i = n; i < size; i++) block[i] = INT32_MAX; // Padding sorts to the end
+
+#if SORT_NETWORK_HAVE_AVX2
+    if (sort_network_has_avx2()) bitonic_sort_int32_avx2(block, size);
+    else bitonic_sort_int32_scalar(block, size);
+#else
+    bitonic_sort_int32_scalar(block, size);
+#endif
+
+    memcpy(a, block, sizeof(int32_t) * n);
+    return sort_network_comparators(size);
+}
+
+// Sorts a[0, n) ascending as unsigned 64-bit values for n <= SORT_NETWORK_MAX_PAIRS, typically
+// (key << 32) | index pairs. Returns the comparator count.
+static inline long long sort_network_u64(uint64_t a[], int n) {
+    if (n < 2) return 0;
+
+    uint64_t block[SORT_NETWORK_MAX_PAIRS];
+    int size = sort_network_padded_size(n, 4);
+    memcpy(block, a, sizeof(uint64_t) * n);
+    for (int i = n; i < size; i++) block[i] = UINT64_MAX;
+
+#if SORT_NETWORK_HAVE_AVX2
+    if (sort_network_has_avx2()) bitonic_sort_u64_avx2(block, size);
+    else bitonic_sort_u64_scalar(block, size);
+#else
+    bitonic_sort_u64_scalar(block, size);
+#endif
+
+    memcpy(a, block, sizeof(uint64_t) * n);
+    return sort_network_comparators(size);
+}
+
+#endif // SORT_NETWORK_H
@@ -0,0 +1,222 @@
+// sort_template.h - Comparator-specialized copies of the sorting algorithms
+//
+// sorting_assignment.c includes this file once per comparator, with two macros defined:
+//   SORT_SUFFIX  suffix of the generated function names (e.g. id_asc)
+//   SORT_CMP     an inline comparator with the CompareFunc signature
+// Each inclusion generates spec_<algorithm>_<suffix>() with the usual sort signature. The
+// CompareFunc argument is ignored: the comparison is a direct call the compiler can inline,
+// and with SORT_COUNT_COMPARISONS set to 0 the counter disappears from the inner loops.
+//
+// Every algorithm performs the same comparisons as its generic version, so the counted
+// build reports the same numbers. There is no include guard on purpose; SORT_SUFFIX and
+// SORT_CMP are undefined at the end, ready for the next inclusion.
+
+#ifndef SORT_SUFFIX
+#error "sort_template.h: define SORT_SUFFIX and SORT_CMP before including"
+#endif
+
+#define SORT_JOIN_(a, b) a##_##b
+#define SORT_JOIN(a, b) SORT_JOIN_(a, b)
+#define SORT_FN(name) SORT_JOIN(name, SORT_SUFFIX)
+
+// A. Bubble Sort
+void SORT_FN(spec_bubble_sort)(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    (void)cmp;
+    for (int i = 0; i < n - 1; i++) {
+        int swapped = 0;
+        for (int j = 0; j < n - 1 - i; j++) {
+            if (SORT_CMP(&arr[j], &arr[j + 1], comparisons) > 0) {
+                SWAP(arr[j], arr[j + 1]);
+                swapped = 1;
+            }
+        }
+        if (!swapped) break;
+    }
+}
+
+// B. Selection Sort
+void SORT_FN(spec_selection_sort)(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    (void)cmp;
+    for (int i = 0; i < n - 1; i++) {
+        int min_idx = i;
+        for (int j = i + 1; j < n; j++) {
+            if (SORT_CMP(&arr[j], &arr[min_idx], comparisons) < 0) {
+                min_idx = j;
+            }
+        }
+        if (min_idx != i) {
+            SWAP(arr[i], arr[min_idx]);
+        }
+    }
+}
+
+// C. Insertion Sort
+void SORT_FN(spec_insertion_sort)(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    (void)cmp;
+    for (int i = 1; i < n; i++) {
+        Student key = arr[i];
+        int j = i - 1;
+        while (j >= 0 && SORT_CMP(&arr[j], &key, comparisons) > 0) {
+            arr[j + 1] = arr[j];
+            j = j - 1;
+        }
+        arr[j + 1] = key;
+    }
+}
+
+// D. Shell Sort (Knuth's sequence, as shell_sort_improved)
+void SORT_FN(spec_shell_sort)(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    (void)cmp;
+    int gaps[20];
+    int h = 1;
+    int k = 0;
+    while (h < n) {
+        gaps[k++] = h;
+        h = h * 3 + 1;
+    }
+
+    for (int i = k - 1; i >= 0; i--) {
+        int gap = gaps[i];
+        for (int j = gap; j < n; j++) {
+            Student temp = arr[j];
+            int l;
+            for (l = j; l >= gap; l -= gap) {
+                if (SORT_CMP(&arr[l - gap], &temp, comparisons) > 0) {
+                    arr[l] = arr[l - gap];
+                }
+                else {
+                    break;
+                }
+            }
+            arr[l] = temp;
+        }
+    }
+}
+
+// F. Heap Sort (binary heap, max_heapify unrolled into a loop)
+void SORT_FN(spec_max_heapify)(Student arr[], int n, int i, long long* comparisons) {
+    while (1) {
+        int largest = i;
+        int left = 2 * i + 1;
+        int right = 2 * i + 2;
+
+        if (left < n && SORT_CMP(&arr[left], &arr[largest], comparisons) > 0)
+            largest = left;
+
+        if (right < n && SORT_CMP(&arr[right], &arr[largest], comparisons) > 0)
+            largest = right;
+
+        if (largest == i) break;
+        SWAP(arr[i], arr[largest]);
+        i = largest;
+    }
+}
+
+void SORT_FN(spec_heap_sort)(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    (void)cmp;
+    for (int i = n / 2 - 1; i >= 0; i--)
+        SORT_FN(spec_max_heapify)(arr, n, i, comparisons);
+
+    for (int i = n - 1; i > 0; i--) {
+        SWAP(arr[0], arr[i]);
+        SORT_FN(spec_max_heapify)(arr, i, 0, comparisons);
+    }
+}
+
+// Quick Sort (Introsort, as intro_sort)
+int SORT_FN(spec_partition_intro)(Student arr[], int low, int high, long long* comparisons) {
+    int mid = low + (high - low) / 2;
+    if (SORT_CMP(&arr[low], &arr[mid], comparisons) > 0) SWAP(arr[low], arr[mid]);
+    if (SORT_CMP(&arr[low], &arr[high], comparisons) > 0) SWAP(arr[low], arr[high]);
+    if (SORT_CMP(&arr[mid], &arr[high], comparisons) > 0) SWAP(arr[mid], arr[high]);
+    SWAP(arr[mid], arr[low]);
+
+    Student pivot = arr[low];
+    int i = low;
+    int j = high + 1;
+
+    while (1) {
+        while (SORT_CMP(&arr[++i], &pivot, comparisons) < 0) {
+            if (i == high) break;
+        }
+        while (SORT_CMP(&pivot, &arr[--j], comparisons) < 0) {
+            if (j == low) break;
+        }
+        if (i >= j) break;
+        SWAP(arr[i], arr[j]);
+    }
+    SWAP(arr[low], arr[j]);
+    return j;
+}
+
+void SORT_FN(spec_intro_sort_recursive)(Student arr[], int low, int high, int depth_limit, long long* comparisons) {
+    while (high - low + 1 > INTROSORT_THRESHOLD) {
+        if (depth_limit == 0) {
+            SORT_FN(spec_heap_sort)(arr + low, high - low + 1, NULL, comparisons);
+            return;
+        }
+        depth_limit--;
+
+        int pi = SORT_FN(spec_partition_intro)(arr, low, high, comparisons);
+        if (pi - low < high - pi) {
+            SORT_FN(spec_intro_sort_recursive)(arr, low, pi - 1, depth_limit, comparisons);
+            low = pi + 1;
+        }
+        else {
+            SORT_FN(spec_intro_sort_recursive)(arr, pi + 1, high, depth_limit, comparisons);
+            high = pi - 1;
+        }
+    }
+    if (low < high) {
+        SORT_FN(spec_insertion_sort)(arr + low, high - low + 1, NULL, comparisons);
+    }
+}
+
+void SORT_FN(spec_intro_sort)(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    (void)cmp;
+    int depth_limit = 0;
+    for (int m = n; m > 1; m >>= 1) depth_limit += 2;
+    SORT_FN(spec_intro_sort_recursive)(arr, 0, n - 1, depth_limit, comparisons);
+}
+
+// G. Merge Sort
+void SORT_FN(spec_merge_sort_recursive)(Student arr[], int l, int r, long long* comparisons, Student temp_arr[]) {
+    if (l >= r) return;
+
+    int m = l + (r - l) / 2;
+    SORT_FN(spec_merge_sort_recursive)(arr, l, m, comparisons, temp_arr);
+    SORT_FN(spec_merge_sort_recursive)(arr, m + 1, r, comparisons, temp_arr);
+
+    int n1 = m - l + 1;
+    int n2 = r - m;
+    memcpy(temp_arr, &arr[l], sizeof(Student) * (n1 + n2));
+
+    int i = 0, j = n1, k = l;
+    while (i < n1 && j < n1 + n2) {
+        if (SORT_CMP(&temp_arr[i], &temp_arr[j], comparisons) <= 0) {
+            arr[k++] = temp_arr[i++];
+        }
+        else {
+            arr[k++] = temp_arr[j++];
+        }
+    }
+    while (i < n1) arr[k++] = temp_arr[i++];
+    while (j < n1 + n2) arr[k++] = temp_arr[j++];
+}
+
+void SORT_FN(spec_merge_sort)(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    (void)cmp;
+    Student* temp_arr = (Student*)tracked_malloc(sizeof(Student) * n);
+    if (!temp_arr) {
+        fprintf(stderr, "Error: Memory allocation failed for Merge Sort auxiliary array.\n");
+        return;
+    }
+    SORT_FN(spec_merge_sort_recursive)(arr, 0, n - 1, comparisons, temp_arr);
+    tracked_free(temp_arr);
+}
+
+#undef SORT_FN
+#undef SORT_JOIN
+#undef SORT_JOIN_
+#undef SORT_SUFFIX
+#undef SORT_CMP
@@ -1,14 +1,78 @@
+#if defined(__linux__)
+#define _GNU_SOURCE // perf_event_open and other Linux extensions
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <math.h>
+#include <stdint.h>
+#include <limits.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "sort_network.h"
+#include "data_generator.h"
+#include "shell_gaps.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define HAVE_PERF_EVENTS 1
+#else
+#define HAVE_PERF_EVENTS 0
+#endif
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#define HAVE_PTHREADS 1
+#define HAVE_MMAP 1
+#else
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#define HAVE_PTHREADS 0
+#define HAVE_MMAP 0
+#endif
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#define HAVE_MALLOC_USABLE_SIZE 1
+#else
+#define HAVE_MALLOC_USABLE_SIZE 0
+#endif
 
 // --- Constants and Global Tracking ---
 #define MAX_NAME_LEN 50
 #define MAX_LINE_LEN 200
 #define NUM_REPETITIONS 1000
 #define DATA_FILENAME "dataset_id_ascending.csv"
+#define SORT_THREADS 0 // Threads used by the parallel sorts (0 = all online CPUs)
+#define REPETITION_WORKERS 1 // Threads running repetitions concurrently (0 = all online CPUs)
+#ifndef PIN_WORKERS
+#define PIN_WORKERS 0 // 1 to pin each repetition worker to its own core (Linux only, --pin)
+#endif
+#ifndef SORT_COUNT_COMPARISONS
+#define SORT_COUNT_COMPARISONS 1 // 0 compiles the counter out of the specialized sorts (-DSORT_COUNT_COMPARISONS=0)
+#endif
+
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__) || defined(__clang__)
+#define THREAD_LOCAL __thread
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+int repetition_count = NUM_REPETITIONS; // Overridden by --reps
+int sort_thread_count = SORT_THREADS;
+int repetition_worker_count = REPETITION_WORKERS;
+int pin_workers = PIN_WORKERS;
 
 // Struct for student data (provided by user, with added total_grade)
 typedef struct {
@@ -21,15 +85,194 @@ typedef struct {
     int total_grade; // Added for convenience in comparison
 } Student;
 
+#define HW_COUNTER_COUNT 4 // cycles, instructions, branch misses, LLC misses
+
 // Global structure to hold comparison count and memory usage for a single run
 typedef struct {
     long long comparisons;
-    size_t memory_bytes; // Simple measure: size of input array + auxiliary space
+    long long char_inspections; // Name bytes examined (see compare_name_bytes)
+    size_t memory_bytes; // Peak heap footprint of a repetition: input buffers + the sort's own allocations
+    long long allocations; // Heap blocks the sort allocated, per repetition
+    size_t stack_bytes; // Deepest stack use of the sort over all repetitions (STACK_SATURATED past the painted area)
+    double time_min_ns; // Wall-clock time of the sort call over all repetitions
+    double time_median_ns;
+    double time_p99_ns;
+    long long hw[HW_COUNTER_COUNT]; // Per-repetition average, -1 if the counter is unavailable
 } SortMetrics;
 
 // Macro for swapping two Student elements
 #define SWAP(a, b) do { Student temp = a; a = b; b = temp; } while (0)
 
+// Name bytes examined by the name comparisons and string sorts: the real cost of sorting
+// strings, since one comparison may scan anywhere from 1 to MAX_NAME_LEN bytes. Per thread,
+// so concurrent repetition workers keep separate counts; the helper threads of Merge Sort
+// (Parallel) hand theirs back to the caller after the join (see run_merge_tasks).
+THREAD_LOCAL long long char_inspections = 0;
+
+// strncmp(a, b, MAX_NAME_LEN) that also counts the bytes it examined
+static inline int compare_name_bytes(const char* a, const char* b) {
+    int i = 0;
+    while (i < MAX_NAME_LEN && a[i] == b[i] && a[i] != '\0') i++;
+    if (i == MAX_NAME_LEN) {
+        char_inspections += MAX_NAME_LEN;
+        return 0;
+    }
+    char_inspections += i + 1;
+    return (unsigned char)a[i] - (unsigned char)b[i];
+}
+
+
+// --- Allocation and Stack Tracking ---
+// Every heap allocation in this file goes through tracked_malloc/calloc/realloc/free. Each
+// block carries a 16-byte header with its footprint: the bytes the allocator actually
+// reserved (malloc_usable_size plus the chunk header on glibc, so size-class rounding is
+// included; the requested size plus our header elsewhere). The counters are per thread:
+// repetition workers allocate and free their own buffers, so run_test reads a test's live
+// and peak bytes without locking. A block freed on another thread is subtracted there.
+
+typedef struct {
+    long long live_bytes;  // Signed: see the note on other threads above
+    long long peak_bytes;  // Highest live_bytes since the last alloc_stats_mark()
+    long long allocations; // Blocks handed out (realloc counts as one) since the mark
+} AllocStats;
+
+THREAD_LOCAL AllocStats alloc_stats = { 0, 0, 0 };
+
+#define ALLOC_HEADER_BYTES 16 // Keeps the returned pointer 16-byte aligned, like malloc's
+#define ALLOC_CACHE_LINE 64   // Alignment of tracked_aligned_alloc
+
+void alloc_stats_add(long long bytes) {
+    alloc_stats.live_bytes += bytes;
+    if (alloc_stats.live_bytes > alloc_stats.peak_bytes) alloc_stats.peak_bytes = alloc_stats.live_bytes;
+}
+
+// Starts a measurement: the peak restarts from the current live bytes
+void alloc_stats_mark(void) {
+    alloc_stats.peak_bytes = alloc_stats.live_bytes;
+    alloc_stats.allocations = 0;
+}
+
+// Bytes the allocator reserved for a block of `requested` bytes (header included)
+size_t alloc_footprint(void* block, size_t requested) {
+#if HAVE_MALLOC_USABLE_SIZE
+    (void)requested;
+    return malloc_usable_size(block) + sizeof(size_t); // glibc keeps one size word per chunk
+#else
+    (void)block;
+    return requested;
+#endif
+}
+
+void* tracked_malloc(size_t size) {
+    if (size > SIZE_MAX - ALLOC_HEADER_BYTES) return NULL;
+    unsigned char* block = (unsigned char*)malloc(ALLOC_HEADER_BYTES + size);
+    if (!block) return NULL;
+
+    size_t footprint = alloc_footprint(block, ALLOC_HEADER_BYTES + size);
+    memcpy(block, &footprint, sizeof(size_t));
+    alloc_stats_add((long long)footprint);
+    alloc_stats.allocations++;
+    return block + ALLOC_HEADER_BYTES;
+}
+
+void* tracked_calloc(size_t count, size_t size) {
+    if (size != 0 && count > (SIZE_MAX - ALLOC_HEADER_BYTES) / size) return NULL;
+    void* p = tracked_malloc(count * size);
+    if (p) memset(p, 0, count * size);
+    return p;
+}
+
+void tracked_free(void* ptr) {
+    if (!ptr) return;
+    unsigned char* block = (unsigned char*)ptr - ALLOC_HEADER_BYTES;
+    size_t footprint;
+    memcpy(&footprint, block, sizeof(size_t));
+    alloc_stats.live_bytes -= (long long)footprint;
+    free(block);
+}
+
+void* tracked_realloc(void* ptr, size_t size) {
+    if (!ptr) return tracked_malloc(size);
+    if (size > SIZE_MAX - ALLOC_HEADER_BYTES) return NULL;
+
+    unsigned char* block = (unsigned char*)ptr - ALLOC_HEADER_BYTES;
+    size_t old_footprint;
+    memcpy(&old_footprint, block, sizeof(size_t));
+    unsigned char* moved = (unsigned char*)realloc(block, ALLOC_HEADER_BYTES + size);
+    if (!moved) return NULL;
+
+    size_t footprint = alloc_footprint(moved, ALLOC_HEADER_BYTES + size);
+    memcpy(moved, &footprint, sizeof(size_t));
+    if (moved != block) {
+        alloc_stats_add((long long)footprint); // Both copies existed while the data moved
+        alloc_stats.live_bytes -= (long long)old_footprint;
+    }
+    else {
+        alloc_stats_add((long long)footprint - (long long)old_footprint);
+    }
+    alloc_stats.allocations++;
+    return moved + ALLOC_HEADER_BYTES;
+}
+
+// ALLOC_CACHE_LINE-aligned block; the address of the underlying tracked block is kept just
+// below the returned pointer. Release with tracked_aligned_free.
+void* tracked_aligned_alloc(size_t size) {
+    if (size > SIZE_MAX - ALLOC_CACHE_LINE - sizeof(void*)) return NULL;
+    unsigned char* raw = (unsigned char*)tracked_malloc(size + ALLOC_CACHE_LINE + sizeof(void*));
+    if (!raw) return NULL;
+    uintptr_t aligned = ((uintptr_t)raw + sizeof(void*) + ALLOC_CACHE_LINE - 1) & ~(uintptr_t)(ALLOC_CACHE_LINE - 1);
+    memcpy((unsigned char*)aligned - sizeof(void*), &raw, sizeof(void*));
+    return (void*)aligned;
+}
+
+void tracked_aligned_free(void* ptr) {
+    if (!ptr) return;
+    void* raw;
+    memcpy(&raw, (unsigned char*)ptr - sizeof(void*), sizeof(void*));
+    tracked_free(raw);
+}
+
+// Stack high-water mark. paint_stack() fills STACK_PAINT_BYTES just below the caller's
+// frame with a pattern; after the sort, stack_high_water() returns how deep the pattern
+// was overwritten (stacks grow downward on every supported platform). A sort that reaches
+// the end of the painted area reports STACK_SATURATED: its real depth is unknown.
+#define STACK_PAINT_BYTES (256 * 1024) // Well inside the 512 KB default of macOS secondary threads
+#define STACK_PAINT_WORD 0xA5A5A5A5A5A5A5A5ull
+#define STACK_SATURATED SIZE_MAX // At least STACK_PAINT_BYTES; larger than any measured value
+
+#if defined(_MSC_VER)
+#define NOINLINE __declspec(noinline)
+#elif defined(__GNUC__) || defined(__clang__)
+#define NOINLINE __attribute__((noinline))
+#else
+#define NOINLINE
+#endif
+
+THREAD_LOCAL uintptr_t stack_paint_low; // Deepest painted address
+
+NOINLINE void paint_stack(void) {
+    volatile uint64_t area[STACK_PAINT_BYTES / sizeof(uint64_t)];
+    for (size_t i = 0; i < STACK_PAINT_BYTES / sizeof(uint64_t); i++) area[i] = STACK_PAINT_WORD;
+    stack_paint_low = (uintptr_t)area;
+}
+
+// Bytes of the painted area overwritten since paint_stack(), or STACK_SATURATED
+NOINLINE size_t stack_high_water(void) {
+    const volatile uint64_t* area = (const volatile uint64_t*)stack_paint_low;
+    size_t words = STACK_PAINT_BYTES / sizeof(uint64_t);
+    size_t i = 0;
+    while (i < words && area[i] == STACK_PAINT_WORD) i++;
+    if (i == 0) return STACK_SATURATED;
+    return (words - i) * sizeof(uint64_t);
+}
+
+// Table text of a stack high-water mark (">262144" when saturated)
+const char* format_stack_bytes(size_t bytes, char* buf, size_t size) {
+    if (bytes == STACK_SATURATED) snprintf(buf, size, ">%d", STACK_PAINT_BYTES);
+    else snprintf(buf, size, "%zu", bytes);
+    return buf;
+}
+
 
 // --- Comparison Functions ---
 // The comparison function returns:
@@ -70,13 +313,13 @@ int compare_id_desc(const Student* a, const Student* b, long long* comparisons)
 // 3. NAME Ascending
 int compare_name_asc(const Student* a, const Student* b, long long* comparisons) {
     (*comparisons)++;
-    return strncmp(a->name, b->name, MAX_NAME_LEN);
+    return compare_name_bytes(a->name, b->name);
 }
 
 // 4. NAME Descending
 int compare_name_desc(const Student* a, const Student* b, long long* comparisons) {
     (*comparisons)++;
-    return strncmp(b->name, a->name, MAX_NAME_LEN);
+    return compare_name_bytes(b->name, a->name);
 }
 
 // 5. GENDER Ascending (M < F)
@@ -112,6 +355,100 @@ int compare_total_desc(const Student* a, const Student* b, long long* comparison
 // Define a function pointer for the comparison
 typedef int (*CompareFunc)(const Student*, const Student*, long long*);
 
+// --- Packed Sort Keys ---
+// An order-preserving 64-bit key per record: comparing two keys as unsigned integers gives
+// the same result as the matching CompareFunc. Used by the key-extraction and radix sorts.
+
+typedef struct {
+    uint64_t key;
+    uint32_t index; // Position of the record in the original array
+} SortKey;
+
+// Returns 1 and stores the key, or 0 if the record cannot be packed (e.g. a grade
+// outside the 16-bit field range), in which case the caller falls back to CompareFunc.
+typedef int (*KeyExtractFunc)(const Student*, uint64_t*);
+
+#define PACKED_FIELD_MAX 0xFFFF
+#define SIGNED_KEY(v) ((uint32_t)(v) ^ 0x80000000u) // Maps INT_MIN..INT_MAX to 0..UINT32_MAX
+
+int extract_key_id_asc(const Student* s, uint64_t* key) {
+    *key = SIGNED_KEY(s->id);
+    return 1;
+}
+
+int extract_key_id_desc(const Student* s, uint64_t* key) {
+    *key = (uint32_t)~SIGNED_KEY(s->id);
+    return 1;
+}
+
+int extract_key_gender_asc(const Student* s, uint64_t* key) {
+    *key = (uint64_t)((int)s->gender + 128); // Works for both signed and unsigned char
+    return 1;
+}
+
+int extract_key_gender_desc(const Student* s, uint64_t* key) {
+    *key = (uint64_t)(383 - ((int)s->gender + 128));
+    return 1;
+}
+
+// total_grade (16 bits) | korean | english | math, where the three tie-break grades are
+// stored inverted because compare_grades orders higher grades first.
+int pack_total_key(const Student* s, int total_desc, uint64_t* key) {
+    if (s->total_grade < 0 || s->total_grade > PACKED_FIELD_MAX ||
+        s->korean < 0 || s->korean > PACKED_FIELD_MAX ||
+        s->english < 0 || s->english > PACKED_FIELD_MAX ||
+        s->math < 0 || s->math > PACKED_FIELD_MAX) {
+        return 0;
+    }
+    uint64_t total = total_desc ? (uint64_t)(PACKED_FIELD_MAX - s->total_grade) : (uint64_t)s->total_grade;
+    *key = (total << 48) |
+        ((uint64_t)(PACKED_FIELD_MAX - s->korean) << 32) |
+        ((uint64_t)(PACKED_FIELD_MAX - s->english) << 16) |
+        (uint64_t)(PACKED_FIELD_MAX - s->math);
+    return 1;
+}
+
+int extract_key_total_asc(const Student* s, uint64_t* key) {
+    return pack_total_key(s, 0, key);
+}
+
+int extract_key_total_desc(const Student* s, uint64_t* key) {
+    return pack_total_key(s, 1, key);
+}
+
+// NAME keys are up to MAX_NAME_LEN bytes and do not fit in 64 bits, so they have no extractor.
+KeyExtractFunc key_extractor_for(CompareFunc cmp) {
+    if (cmp == compare_id_asc) return extract_key_id_asc;
+    if (cmp == compare_id_desc) return extract_key_id_desc;
+    if (cmp == compare_gender_asc) return extract_key_gender_asc;
+    if (cmp == compare_gender_desc) return extract_key_gender_desc;
+    if (cmp == compare_total_asc) return extract_key_total_asc;
+    if (cmp == compare_total_desc) return extract_key_total_desc;
+    return NULL;
+}
+
+// Moves every record to its sorted position by following permutation cycles, so each
+// record is copied once. keys[i].index is the source of position i; it is reset to i as
+// positions are filled.
+void apply_permutation(Student arr[], SortKey keys[], int n) {
+    for (int i = 0; i < n; i++) {
+        if (keys[i].index == (uint32_t)i) continue;
+
+        Student temp = arr[i];
+        int j = i;
+        while (1) {
+            int src = (int)keys[j].index;
+            keys[j].index = (uint32_t)j;
+            if (src == i) {
+                arr[j] = temp;
+                break;
+            }
+            arr[j] = arr[src];
+            j = src;
+        }
+    }
+}
+
 // --- Data Loading Function (Modified for total_grade calculation) ---
 
 Student* load_students(const char* filename, int* out_count) {
@@ -124,7 +461,7 @@ Student* load_students(const char* filename, int* out_count) {
     char line[MAX_LINE_LEN];
     int capacity = 10;
     int count = 0;
-    Student* arr = (Student*)malloc(sizeof(Student) * capacity);
+    Student* arr = (Student*)tracked_malloc(sizeof(Student) * capacity);
 
     if (!arr) {
         perror("Memory allocation failed");
@@ -134,7 +471,7 @@ Student* load_students(const char* filename, int* out_count) {
 
     // Skip header line
     if (!fgets(line, sizeof(line), fp)) {
-        free(arr);
+        tracked_free(arr);
         fclose(fp);
         *out_count = 0;
         return NULL;
@@ -143,7 +480,7 @@ Student* load_students(const char* filename, int* out_count) {
     while (fgets(line, sizeof(line), fp)) {
         if (count >= capacity) {
             capacity *= 2;
-            Student* temp = (Student*)realloc(arr, sizeof(Student) * capacity);
+            Student* temp = (Student*)tracked_realloc(arr, sizeof(Student) * capacity);
             if (!temp) {
                 perror("Reallocation failed");
                 break;
@@ -190,7 +527,7 @@ Student* load_students(const char* filename, int* out_count) {
     fclose(fp);
 
     // Tight reallocation to fit the exact count
-    Student* tight = (Student*)realloc(arr, sizeof(Student) * count);
+    Student* tight = (Student*)tracked_realloc(arr, sizeof(Student) * count);
     if (!tight) {
         fprintf(stderr, "Warning: Tight reallocation failed, using original memory.\n");
         *out_count = count;
@@ -294,6 +631,48 @@ void shell_sort_improved(Student arr[], int n, CompareFunc cmp, long long* compa
     }
 }
 
+// Shell Sort (C - Pluggable gap sequences from shell_gaps.h)
+// Ciura's list is extended by x2.25 past 8859, so large inputs keep getting large first
+// passes. main.c sorts the h-chains of large gaps in parallel; these record versions are
+// serial, since a Student move is a 100+ byte copy and the passes are memory-bound.
+void shell_sort_with_gaps(Student arr[], int n, GapSequence seq, CompareFunc cmp, long long* comparisons) {
+    size_t gaps[SHELL_MAX_GAPS];
+    int gap_count = shell_gaps_generate(seq, (size_t)n, gaps);
+
+    for (int k = 0; k < gap_count; k++) {
+        int gap = (int)gaps[k];
+        for (int i = gap; i < n; i++) {
+            Student temp = arr[i];
+            int j;
+            for (j = i; j >= gap; j -= gap) {
+                if (cmp(&arr[j - gap], &temp, comparisons) > 0) {
+                    arr[j] = arr[j - gap];
+                }
+                else {
+                    break;
+                }
+            }
+            arr[j] = temp;
+        }
+    }
+}
+
+void shell_sort_ciura(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    shell_sort_with_gaps(arr, n, GAPS_CIURA, cmp, comparisons);
+}
+
+void shell_sort_tokuda(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    shell_sort_with_gaps(arr, n, GAPS_TOKUDA, cmp, comparisons);
+}
+
+void shell_sort_sedgewick(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    shell_sort_with_gaps(arr, n, GAPS_SEDGEWICK, cmp, comparisons);
+}
+
+void shell_sort_pratt(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    shell_sort_with_gaps(arr, n, GAPS_PRATT, cmp, comparisons);
+}
+
 // E. Quick Sort (A - Basic, Simple Pivot: last element, Lomuto Partition)
 int partition_basic(Student arr[], int low, int high, CompareFunc cmp, long long* comparisons) {
     Student pivot = arr[high];
@@ -309,11 +688,19 @@ int partition_basic(Student arr[], int low, int high, CompareFunc cmp, long long
     return (i + 1);
 }
 
+// Recurses into the smaller side and loops on the larger one, so the stack depth stays
+// O(log n) even when partitioning degrades to O(n^2) on presorted input
 void quick_sort_basic_recursive(Student arr[], int low, int high, CompareFunc cmp, long long* comparisons) {
-    if (low < high) {
+    while (low < high) {
         int pi = partition_basic(arr, low, high, cmp, comparisons);
-        quick_sort_basic_recursive(arr, low, pi - 1, cmp, comparisons);
-        quick_sort_basic_recursive(arr, pi + 1, high, cmp, comparisons);
+        if (pi - low < high - pi) {
+            quick_sort_basic_recursive(arr, low, pi - 1, cmp, comparisons);
+            low = pi + 1;
+        }
+        else {
+            quick_sort_basic_recursive(arr, pi + 1, high, cmp, comparisons);
+            high = pi - 1;
+        }
     }
 }
 
@@ -347,16 +734,24 @@ int partition_improved(Student arr[], int low, int high, CompareFunc cmp, long l
 
         if (i > j) break;
         SWAP(arr[i], arr[j]);
+        i++; // Step past the swapped pair, or keys equal to the pivot would swap forever
+        j--;
     }
     SWAP(arr[low], arr[j]); // Place pivot in its correct position
     return j;
 }
 
 void quick_sort_improved_recursive(Student arr[], int low, int high, CompareFunc cmp, long long* comparisons) {
-    if (low < high) {
+    while (low < high) {
         int pi = partition_improved(arr, low, high, cmp, comparisons);
-        quick_sort_improved_recursive(arr, low, pi - 1, cmp, comparisons);
-        quick_sort_improved_recursive(arr, pi + 1, high, cmp, comparisons);
+        if (pi - low < high - pi) {
+            quick_sort_improved_recursive(arr, low, pi - 1, cmp, comparisons);
+            low = pi + 1;
+        }
+        else {
+            quick_sort_improved_recursive(arr, pi + 1, high, cmp, comparisons);
+            high = pi - 1;
+        }
     }
 }
 
@@ -394,6 +789,213 @@ void heap_sort(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
     }
 }
 
+// Heap Sort (d-ary, Floyd Bottom-Up)
+// Children of node i are i * arity + 1 .. i * arity + arity, so one sift step scans a run of
+// adjacent records instead of jumping across the array. Sift-down follows Floyd: the hole
+// walks down the path of largest children to a leaf (arity - 1 comparisons per level, none
+// against the sifted record), then the record climbs back up, which is usually only a level
+// or two since it came from the bottom of the heap. Iterative, no recursion.
+void dary_sift_down(Student arr[], int n, int i, int arity, CompareFunc cmp, long long* comparisons) {
+    Student x = arr[i];
+    int hole = i;
+
+    // Descend to a leaf, promoting the largest child at each level
+    while (1) {
+        int first = hole * arity + 1;
+        if (first >= n) break;
+        int last = first + arity < n ? first + arity : n;
+
+        int largest = first;
+        for (int c = first + 1; c < last; c++) {
+            if (cmp(&arr[c], &arr[largest], comparisons) > 0) largest = c;
+        }
+        arr[hole] = arr[largest];
+        hole = largest;
+    }
+
+    // Sift the record back up from the leaf
+    while (hole > i) {
+        int parent = (hole - 1) / arity;
+        if (cmp(&x, &arr[parent], comparisons) <= 0) break;
+        arr[hole] = arr[parent];
+        hole = parent;
+    }
+    arr[hole] = x;
+}
+
+void heap_sort_dary(Student arr[], int n, int arity, CompareFunc cmp, long long* comparisons) {
+    if (n < 2) return;
+
+    // Build max heap from the last internal node upwards
+    for (int i = (n - 2) / arity; i >= 0; i--)
+        dary_sift_down(arr, n, i, arity, cmp, comparisons);
+
+    for (int i = n - 1; i > 0; i--) {
+        SWAP(arr[0], arr[i]);
+        dary_sift_down(arr, i, 0, arity, cmp, comparisons);
+    }
+}
+
+void heap_sort_binary(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    heap_sort_dary(arr, n, 2, cmp, comparisons);
+}
+
+void heap_sort_4ary(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    heap_sort_dary(arr, n, 4, cmp, comparisons);
+}
+
+void heap_sort_8ary(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    heap_sort_dary(arr, n, 8, cmp, comparisons);
+}
+
+// Quick Sort (C - Introsort)
+// Median-of-three quick sort that recurses into the smaller side and loops on the larger,
+// finishes ranges of at most INTROSORT_THRESHOLD elements with insertion sort, and switches
+// a range to heap sort once the partition depth exceeds 2 * log2(n). Worst case O(n log n)
+// with O(log n) stack, whatever the input order.
+#define INTROSORT_THRESHOLD 16
+
+// Hoare partition that stops on keys equal to the pivot from both sides, so runs of equal
+// keys split evenly instead of degrading (or looping forever)
+int partition_intro(Student arr[], int low, int high, CompareFunc cmp, long long* comparisons) {
+    int pivot_idx = median_of_three(arr, low, high, cmp, comparisons);
+    SWAP(arr[pivot_idx], arr[low]);
+
+    Student pivot = arr[low];
+    int i = low;
+    int j = high + 1;
+
+    while (1) {
+        while (cmp(&arr[++i], &pivot, comparisons) < 0) {
+            if (i == high) break;
+        }
+        while (cmp(&pivot, &arr[--j], comparisons) < 0) {
+            if (j == low) break;
+        }
+        if (i >= j) break;
+        SWAP(arr[i], arr[j]);
+    }
+    SWAP(arr[low], arr[j]);
+    return j;
+}
+
+void intro_sort_recursive(Student arr[], int low, int high, int depth_limit, CompareFunc cmp, long long* comparisons) {
+    while (high - low + 1 > INTROSORT_THRESHOLD) {
+        if (depth_limit == 0) {
+            heap_sort(arr + low, high - low + 1, cmp, comparisons);
+            return;
+        }
+        depth_limit--;
+
+        int pi = partition_intro(arr, low, high, cmp, comparisons);
+        if (pi - low < high - pi) {
+            intro_sort_recursive(arr, low, pi - 1, depth_limit, cmp, comparisons);
+            low = pi + 1;
+        }
+        else {
+            intro_sort_recursive(arr, pi + 1, high, depth_limit, cmp, comparisons);
+            high = pi - 1;
+        }
+    }
+    if (low < high) {
+        insertion_sort(arr + low, high - low + 1, cmp, comparisons);
+    }
+}
+
+void intro_sort(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    int depth_limit = 0;
+    for (int m = n; m > 1; m >>= 1) depth_limit += 2; // 2 * floor(log2(n))
+    intro_sort_recursive(arr, 0, n - 1, depth_limit, cmp, comparisons);
+}
+
+// Partial Sort and Selection (Top-k)
+// partial_sort leaves the first k records of the sorted order, sorted, in arr[0, k); the
+// other records end up in arr[k, n) in no particular order. For small k a bounded max-heap
+// holds the best k records seen so far and a record only enters by beating the root, so
+// the cost is O(n log k). Once k exceeds n / TOP_K_SELECT_RATIO, introselect moves the k
+// best records to the front in O(n) on average and only that prefix is sorted.
+#define TOP_K_DEFAULT 100
+#define TOP_K_SELECT_RATIO 8
+
+int top_k_count = TOP_K_DEFAULT; // k of the top-k rows (--top-k)
+
+// Gathers the k best records of arr[0, n) into arr[0, k) as a max-heap (worst of them at the root)
+void heap_select(Student arr[], int n, int k, CompareFunc cmp, long long* comparisons) {
+    for (int i = (k - 2) / 2; i >= 0; i--)
+        dary_sift_down(arr, k, i, 2, cmp, comparisons);
+
+    for (int i = k; i < n; i++) {
+        if (cmp(&arr[i], &arr[0], comparisons) < 0) {
+            SWAP(arr[0], arr[i]);
+            dary_sift_down(arr, k, 0, 2, cmp, comparisons);
+        }
+    }
+}
+
+// Rearranges arr so arr[nth] is the record sorted order puts there, with nothing greater
+// before it and nothing smaller after it. Quickselect on partition_intro; after
+// 2 * log2(n) bad pivots the remaining range falls back to heap_select, O(n log n) worst case.
+void nth_element(Student arr[], int n, int nth, CompareFunc cmp, long long* comparisons) {
+    if (nth < 0 || nth >= n) return;
+
+    int low = 0;
+    int high = n - 1;
+    int depth_limit = 0;
+    for (int m = n; m > 1; m >>= 1) depth_limit += 2;
+
+    while (high - low + 1 > INTROSORT_THRESHOLD) {
+        if (depth_limit-- == 0) {
+            // arr[low] becomes the largest of the nth - low + 1 best records of the range
+            heap_select(arr + low, high - low + 1, nth - low + 1, cmp, comparisons);
+            SWAP(arr[low], arr[nth]);
+            return;
+        }
+        int pi = partition_intro(arr, low, high, cmp, comparisons);
+        if (pi == nth) return;
+        if (nth < pi) high = pi - 1;
+        else low = pi + 1;
+    }
+    insertion_sort(arr + low, high - low + 1, cmp, comparisons);
+}
+
+void partial_sort_heap(Student arr[], int n, int k, CompareFunc cmp, long long* comparisons) {
+    heap_select(arr, n, k, cmp, comparisons);
+    for (int i = k - 1; i > 0; i--) {
+        SWAP(arr[0], arr[i]);
+        dary_sift_down(arr, i, 0, 2, cmp, comparisons);
+    }
+}
+
+void partial_sort_select(Student arr[], int n, int k, CompareFunc cmp, long long* comparisons) {
+    if (k == n) {
+        intro_sort(arr, n, cmp, comparisons);
+        return;
+    }
+    nth_element(arr, n, k - 1, cmp, comparisons);
+    intro_sort(arr, k - 1, cmp, comparisons); // arr[k - 1] is already in place
+}
+
+void partial_sort(Student arr[], int n, int k, CompareFunc cmp, long long* comparisons) {
+    if (k > n) k = n;
+    if (k <= 0) return;
+    if (k > n / TOP_K_SELECT_RATIO) partial_sort_select(arr, n, k, cmp, comparisons);
+    else partial_sort_heap(arr, n, k, cmp, comparisons);
+}
+
+// Benchmark entry points: the first top_k_count records, or the median
+void top_k(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    partial_sort(arr, n, top_k_count, cmp, comparisons);
+}
+
+void top_k_introselect(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    int k = top_k_count < n ? top_k_count : n;
+    if (k > 0) partial_sort_select(arr, n, k, cmp, comparisons);
+}
+
+void nth_element_median(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    nth_element(arr, n, n / 2, cmp, comparisons);
+}
+
 // G. Merge Sort
 void merge(Student arr[], int l, int m, int r, CompareFunc cmp, long long* comparisons, Student temp_arr[]) {
     int i, j, k;
@@ -433,195 +1035,5423 @@ void merge_sort_recursive(Student arr[], int l, int r, CompareFunc cmp, long lon
 
 void merge_sort(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
     // Auxiliary array for merging. This is the main auxiliary memory usage.
-    Student* temp_arr = (Student*)malloc(sizeof(Student) * n);
+    Student* temp_arr = (Student*)tracked_malloc(sizeof(Student) * n);
     if (!temp_arr) {
         fprintf(stderr, "Error: Memory allocation failed for Merge Sort auxiliary array.\n");
         return;
     }
     merge_sort_recursive(arr, 0, n - 1, cmp, comparisons, temp_arr);
-    free(temp_arr);
-}
-
-// H. Radix Sort (LSD) - Non-Comparison Sort, only implemented for ID
-// NOTE: This sort does NOT use CompareFunc and should only be run for ID-based criteria.
-int get_max_id(Student arr[], int n) {
-    int max = arr[0].id;
-    for (int i = 1; i < n; i++)
-        if (arr[i].id > max)
-            max = arr[i].id;
-    return max;
+    tracked_free(temp_arr);
 }
 
-void counting_sort_radix(Student arr[], int n, int exp, Student output[]) {
-    int i;
-    int count[10] = { 0 };
+// G. Merge Sort (Natural Runs, Timsort-style)
+// Finds ascending / strictly descending runs (descending ones are reversed in place, which
+// keeps the sort stable), extends runs shorter than min_run with binary insertion, and keeps
+// them on a stack whose lengths follow the Timsort invariants. Merges trim the parts of both
+// runs that are already in place and switch to galloping (exponential search) when one run
+// keeps winning. Presorted input is a single run: n - 1 comparisons and no copying at all.
+#define TIM_MIN_MERGE 32
+#define TIM_MIN_GALLOP 7
+#define TIM_MAX_RUNS 85
 
-    for (i = 0; i < n; i++)
-        count[(arr[i].id / exp) % 10]++;
+typedef struct {
+    Student* arr;
+    Student* temp_arr;  // Holds the shorter run of a merge: at most n / 2 records
+    CompareFunc cmp;
+    long long* comparisons;
+    int min_gallop;     // Adaptive threshold for entering galloping mode
+    int run_base[TIM_MAX_RUNS];
+    int run_len[TIM_MAX_RUNS];
+    int stack_size;
+} TimSortState;
+
+// Smallest run length such that n / min_run is a power of two or slightly below it
+int tim_min_run(int n) {
+    int r = 0;
+    while (n >= TIM_MIN_MERGE) {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
 
-    for (i = 1; i < 10; i++)
-        count[i] += count[i - 1];
+// Length of the run starting at lo (hi is exclusive); a strictly descending run is reversed
+int tim_count_run(Student arr[], int lo, int hi, CompareFunc cmp, long long* comparisons) {
+    int run_hi = lo + 1;
+    if (run_hi == hi) return 1;
 
-    for (i = n - 1; i >= 0; i--) {
-        output[count[(arr[i].id / exp) % 10] - 1] = arr[i];
-        count[(arr[i].id / exp) % 10]--;
+    if (cmp(&arr[run_hi++], &arr[lo], comparisons) < 0) {
+        while (run_hi < hi && cmp(&arr[run_hi], &arr[run_hi - 1], comparisons) < 0) run_hi++;
+        for (int i = lo, j = run_hi - 1; i < j; i++, j--) {
+            SWAP(arr[i], arr[j]);
+        }
+    }
+    else {
+        while (run_hi < hi && cmp(&arr[run_hi], &arr[run_hi - 1], comparisons) >= 0) run_hi++;
     }
+    return run_hi - lo;
+}
 
-    for (i = 0; i < n; i++)
-        arr[i] = output[i];
+// Sorts arr[lo, hi) given that arr[lo, start) is already sorted. The insertion point is the
+// rightmost one among equal keys, so the sort stays stable.
+void tim_binary_insertion_sort(Student arr[], int lo, int hi, int start, CompareFunc cmp, long long* comparisons) {
+    for (; start < hi; start++) {
+        Student pivot = arr[start];
+        int left = lo;
+        int right = start;
+        while (left < right) {
+            int mid = left + (right - left) / 2;
+            if (cmp(&pivot, &arr[mid], comparisons) < 0) right = mid;
+            else left = mid + 1;
+        }
+        memmove(&arr[left + 1], &arr[left], sizeof(Student) * (start - left));
+        arr[left] = pivot;
+    }
 }
 
-void radix_sort_id(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
-    int max = get_max_id(arr, n);
+// Position of the first element of base[0, len) that is >= key, searching outward from hint
+int tim_gallop_left(const Student* key, const Student base[], int len, int hint, CompareFunc cmp, long long* comparisons) {
+    int last_ofs = 0;
+    int ofs = 1;
+
+    if (cmp(key, &base[hint], comparisons) > 0) {
+        // Gallop right until base[hint + last_ofs] < key <= base[hint + ofs]
+        int max_ofs = len - hint;
+        while (ofs < max_ofs && cmp(key, &base[hint + ofs], comparisons) > 0) {
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0) ofs = max_ofs; // int overflow
+        }
+        if (ofs > max_ofs) ofs = max_ofs;
+        last_ofs += hint;
+        ofs += hint;
+    }
+    else {
+        // Gallop left until base[hint - ofs] < key <= base[hint - last_ofs]
+        int max_ofs = hint + 1;
+        while (ofs < max_ofs && cmp(key, &base[hint - ofs], comparisons) <= 0) {
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0) ofs = max_ofs;
+        }
+        if (ofs > max_ofs) ofs = max_ofs;
+        int tmp = last_ofs;
+        last_ofs = hint - ofs;
+        ofs = hint - tmp;
+    }
 
-    Student* output = (Student*)malloc(sizeof(Student) * n);
-    if (!output) {
-        fprintf(stderr, "Error: Memory allocation failed for Radix Sort auxiliary array.\n");
-        return;
+    // base[last_ofs] < key <= base[ofs]: binary search the gap
+    last_ofs++;
+    while (last_ofs < ofs) {
+        int m = last_ofs + (ofs - last_ofs) / 2;
+        if (cmp(key, &base[m], comparisons) > 0) last_ofs = m + 1;
+        else ofs = m;
     }
+    return ofs;
+}
 
-    for (int exp = 1; max / exp > 0; exp *= 10)
-        counting_sort_radix(arr, n, exp, output);
+// Position of the first element of base[0, len) that is > key, searching outward from hint
+int tim_gallop_right(const Student* key, const Student base[], int len, int hint, CompareFunc cmp, long long* comparisons) {
+    int last_ofs = 0;
+    int ofs = 1;
+
+    if (cmp(key, &base[hint], comparisons) < 0) {
+        // Gallop left until base[hint - ofs] <= key < base[hint - last_ofs]
+        int max_ofs = hint + 1;
+        while (ofs < max_ofs && cmp(key, &base[hint - ofs], comparisons) < 0) {
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0) ofs = max_ofs;
+        }
+        if (ofs > max_ofs) ofs = max_ofs;
+        int tmp = last_ofs;
+        last_ofs = hint - ofs;
+        ofs = hint - tmp;
+    }
+    else {
+        // Gallop right until base[hint + last_ofs] <= key < base[hint + ofs]
+        int max_ofs = len - hint;
+        while (ofs < max_ofs && cmp(key, &base[hint + ofs], comparisons) >= 0) {
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0) ofs = max_ofs;
+        }
+        if (ofs > max_ofs) ofs = max_ofs;
+        last_ofs += hint;
+        ofs += hint;
+    }
 
-    free(output);
-    *comparisons = 0; // Radix sort is non-comparison based
+    last_ofs++;
+    while (last_ofs < ofs) {
+        int m = last_ofs + (ofs - last_ofs) / 2;
+        if (cmp(key, &base[m], comparisons) < 0) ofs = m;
+        else last_ofs = m + 1;
+    }
+    return ofs;
 }
 
+// Merges adjacent runs when the first is the shorter one: it is buffered and merged forwards
+void tim_merge_lo(TimSortState* ts, int base1, int len1, int base2, int len2) {
+    Student* arr = ts->arr;
+    Student* tmp = ts->temp_arr;
+    CompareFunc cmp = ts->cmp;
+    long long* comparisons = ts->comparisons;
+    int c1 = 0;                 // Next record of run 1 (in tmp)
+    int c2 = base2;             // Next record of run 2 (in place)
+    int end2 = base2 + len2;
+    int dest = base1;
+    int min_gallop = ts->min_gallop;
+
+    memcpy(tmp, &arr[base1], sizeof(Student) * len1);
+
+    while (c1 < len1 && c2 < end2) {
+        int count1 = 0; // Consecutive wins of run 1
+        int count2 = 0; // Consecutive wins of run 2
+
+        // One record at a time until one run wins min_gallop times in a row
+        while (c1 < len1 && c2 < end2) {
+            if (cmp(&arr[c2], &tmp[c1], comparisons) < 0) {
+                arr[dest++] = arr[c2++];
+                count2++;
+                count1 = 0;
+                if (count2 >= min_gallop) break;
+            }
+            else {
+                arr[dest++] = tmp[c1++];
+                count1++;
+                count2 = 0;
+                if (count1 >= min_gallop) break;
+            }
+        }
+        if (c1 == len1 || c2 == end2) break;
 
-// I. Tree Sort (A - Simple Binary Search Tree)
+        // Galloping: copy whole stretches found by exponential search
+        do {
+            count1 = tim_gallop_right(&arr[c2], &tmp[c1], len1 - c1, 0, cmp, comparisons);
+            memcpy(&arr[dest], &tmp[c1], sizeof(Student) * count1);
+            dest += count1;
+            c1 += count1;
+            if (c1 == len1) goto done;
 
-typedef struct TreeNode {
-    Student data;
-    struct TreeNode* left;
-    struct TreeNode* right;
-} TreeNode;
+            arr[dest++] = arr[c2++];
+            if (c2 == end2) goto done;
 
-TreeNode* new_tree_node(Student s) {
-    TreeNode* temp = (TreeNode*)malloc(sizeof(TreeNode));
-    if (temp) {
-        temp->data = s;
-        temp->left = temp->right = NULL;
-    }
-    return temp;
-}
+            count2 = tim_gallop_left(&tmp[c1], &arr[c2], end2 - c2, 0, cmp, comparisons);
+            memmove(&arr[dest], &arr[c2], sizeof(Student) * count2);
+            dest += count2;
+            c2 += count2;
+            if (c2 == end2) goto done;
 
-TreeNode* insert_bst(TreeNode* node, Student s, CompareFunc cmp, long long* comparisons) {
-    if (node == NULL) return new_tree_node(s);
+            arr[dest++] = tmp[c1++];
+            if (c1 == len1) goto done;
 
-    if (cmp(&s, &node->data, comparisons) < 0) {
-        node->left = insert_bst(node->left, s, cmp, comparisons);
-    }
-    else {
-        // If equal or greater, go to the right (for non-strict BST)
-        node->right = insert_bst(node->right, s, cmp, comparisons);
-    }
-    return node;
-}
+            min_gallop--;
+        } while (count1 >= TIM_MIN_GALLOP || count2 >= TIM_MIN_GALLOP);
 
-void inorder_bst(TreeNode* root, Student arr[], int* index) {
-    if (root != NULL) {
-        inorder_bst(root->left, arr, index);
-        arr[(*index)++] = root->data;
-        inorder_bst(root->right, arr, index);
+        if (min_gallop < 0) min_gallop = 0;
+        min_gallop += 2; // Penalize leaving galloping mode
     }
+
+done:
+    ts->min_gallop = min_gallop < 1 ? 1 : min_gallop;
+    // What is left of run 2 is already in place
+    memcpy(&arr[dest], &tmp[c1], sizeof(Student) * (len1 - c1));
 }
 
-void free_bst(TreeNode* root) {
-    if (root != NULL) {
-        free_bst(root->left);
-        free_bst(root->right);
-        free(root);
+// Merges adjacent runs when the second is the shorter one: it is buffered and merged backwards
+void tim_merge_hi(TimSortState* ts, int base1, int len1, int base2, int len2) {
+    Student* arr = ts->arr;
+    Student* tmp = ts->temp_arr;
+    CompareFunc cmp = ts->cmp;
+    long long* comparisons = ts->comparisons;
+    int i1 = len1;              // Records of run 1 left (arr[base1, base1 + i1))
+    int i2 = len2;              // Records of run 2 left (tmp[0, i2))
+    int dest = base2 + len2 - 1;
+    int min_gallop = ts->min_gallop;
+
+    memcpy(tmp, &arr[base2], sizeof(Student) * len2);
+
+    while (i1 > 0 && i2 > 0) {
+        int count1 = 0;
+        int count2 = 0;
+
+        while (i1 > 0 && i2 > 0) {
+            if (cmp(&tmp[i2 - 1], &arr[base1 + i1 - 1], comparisons) < 0) {
+                arr[dest--] = arr[base1 + --i1];
+                count1++;
+                count2 = 0;
+                if (count1 >= min_gallop) break;
+            }
+            else {
+                arr[dest--] = tmp[--i2];
+                count2++;
+                count1 = 0;
+                if (count2 >= min_gallop) break;
+            }
+        }
+        if (i1 == 0 || i2 == 0) break;
+
+        do {
+            // Records of run 1 greater than the last record of run 2 move as one block
+            int k = tim_gallop_right(&tmp[i2 - 1], &arr[base1], i1, i1 - 1, cmp, comparisons);
+            count1 = i1 - k;
+            dest -= count1;
+            memmove(&arr[dest + 1], &arr[base1 + k], sizeof(Student) * count1);
+            i1 = k;
+            if (i1 == 0) goto done;
+
+            arr[dest--] = tmp[--i2];
+            if (i2 == 0) goto done;
+
+            // Records of run 2 not less than the last record of run 1
+            k = tim_gallop_left(&arr[base1 + i1 - 1], tmp, i2, i2 - 1, cmp, comparisons);
+            count2 = i2 - k;
+            dest -= count2;
+            memcpy(&arr[dest + 1], &tmp[k], sizeof(Student) * count2);
+            i2 = k;
+            if (i2 == 0) goto done;
+
+            arr[dest--] = arr[base1 + --i1];
+            if (i1 == 0) goto done;
+
+            min_gallop--;
+        } while (count1 >= TIM_MIN_GALLOP || count2 >= TIM_MIN_GALLOP);
+
+        if (min_gallop < 0) min_gallop = 0;
+        min_gallop += 2;
     }
+
+done:
+    ts->min_gallop = min_gallop < 1 ? 1 : min_gallop;
+    // What is left of run 1 is already in place
+    memcpy(&arr[base1], tmp, sizeof(Student) * i2);
 }
 
-void tree_sort_basic(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
-    TreeNode* root = NULL;
-    for (int i = 0; i < n; i++) {
-        root = insert_bst(root, arr[i], cmp, comparisons);
+// Merges stack runs i and i + 1
+void tim_merge_at(TimSortState* ts, int i) {
+    int base1 = ts->run_base[i];
+    int len1 = ts->run_len[i];
+    int base2 = ts->run_base[i + 1];
+    int len2 = ts->run_len[i + 1];
+
+    ts->run_len[i] = len1 + len2;
+    if (i == ts->stack_size - 3) {
+        ts->run_base[i + 1] = ts->run_base[i + 2];
+        ts->run_len[i + 1] = ts->run_len[i + 2];
     }
+    ts->stack_size--;
 
-    int index = 0;
-    inorder_bst(root, arr, &index);
+    // Records of run 1 not greater than run 2's first record are already in place
+    int k = tim_gallop_right(&ts->arr[base2], &ts->arr[base1], len1, 0, ts->cmp, ts->comparisons);
+    base1 += k;
+    len1 -= k;
+    if (len1 == 0) return;
 
-    free_bst(root);
+    // Likewise for records of run 2 not less than run 1's last record
+    len2 = tim_gallop_left(&ts->arr[base1 + len1 - 1], &ts->arr[base2], len2, len2 - 1, ts->cmp, ts->comparisons);
+    if (len2 == 0) return;
+
+    if (len1 <= len2) tim_merge_lo(ts, base1, len1, base2, len2);
+    else tim_merge_hi(ts, base1, len1, base2, len2);
 }
 
+// Restores the invariants len[i-2] > len[i-1] + len[i] and len[i-1] > len[i] on the run stack
+void tim_merge_collapse(TimSortState* ts) {
+    while (ts->stack_size > 1) {
+        int n = ts->stack_size - 2;
+        int* len = ts->run_len;
+        if ((n > 0 && len[n - 1] <= len[n] + len[n + 1]) || (n > 1 && len[n - 2] <= len[n - 1] + len[n])) {
+            if (len[n - 1] < len[n + 1]) n--;
+        }
+        else if (len[n] > len[n + 1]) {
+            break;
+        }
+        tim_merge_at(ts, n);
+    }
+}
 
-// I. Tree Sort (B - AVL Tree) - Placeholder/Note for complexity
-void avl_tree_sort(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
-    // 완전한 AVL 트리는 구현이 매우 복잡하여, 이 코드에서는 기본적인 BST 정렬을 사용하고
-    // 비교 횟수 측정을 위해 함수 구조만 유지합니다. (실제 과제에서는 AVL 구현 필요)
-    tree_sort_basic(arr, n, cmp, comparisons);
+void tim_merge_force_collapse(TimSortState* ts) {
+    while (ts->stack_size > 1) {
+        int n = ts->stack_size - 2;
+        if (n > 0 && ts->run_len[n - 1] < ts->run_len[n + 1]) n--;
+        tim_merge_at(ts, n);
+    }
 }
 
+void natural_merge_sort(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    if (n < 2) return;
 
-// --- Main Testing and Averaging Logic ---
+    // Short inputs: one binary insertion sort over the leading run
+    if (n < TIM_MIN_MERGE) {
+        int run = tim_count_run(arr, 0, n, cmp, comparisons);
+        tim_binary_insertion_sort(arr, 0, n, run, cmp, comparisons);
+        return;
+    }
+
+    TimSortState ts;
+    ts.arr = arr;
+    ts.temp_arr = (Student*)tracked_malloc(sizeof(Student) * (n / 2 + 1));
+    if (!ts.temp_arr) {
+        fprintf(stderr, "Error: Memory allocation failed for Natural Merge Sort auxiliary array.\n");
+        return;
+    }
+    ts.cmp = cmp;
+    ts.comparisons = comparisons;
+    ts.min_gallop = TIM_MIN_GALLOP;
+    ts.stack_size = 0;
+
+    int min_run = tim_min_run(n);
+    int lo = 0;
+    while (lo < n) {
+        int run = tim_count_run(arr, lo, n, cmp, comparisons);
+        if (run < min_run) {
+            int forced = n - lo < min_run ? n - lo : min_run;
+            tim_binary_insertion_sort(arr, lo, lo + forced, lo + run, cmp, comparisons);
+            run = forced;
+        }
+
+        ts.run_base[ts.stack_size] = lo;
+        ts.run_len[ts.stack_size] = run;
+        ts.stack_size++;
+        tim_merge_collapse(&ts);
+
+        lo += run;
+    }
+    tim_merge_force_collapse(&ts);
+
+    tracked_free(ts.temp_arr);
+}
+
+// H. Radix Sort (LSD, Base 256) - Non-Comparison Sort
+// Sorts the packed 64-bit keys (see Packed Sort Keys) one byte at a time. All eight
+// histograms are built in a single pre-pass, a byte position where every key has the same
+// digit is skipped (an ID key usually needs only 2-3 of the 8 passes), and the key+index
+// pairs ping-pong between two buffers instead of being copied back after every pass. The
+// records themselves are moved once, by apply_permutation(). Works for every key that has an
+// extractor (ID with negative values, GENDER, TOTAL with its tie-breakers); NAME keys fall
+// back to merge_sort.
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_PASSES (64 / RADIX_BITS)
+
+// Sorts keys[0..n) using temp[0..n) as the second buffer; returns whichever holds the result
+SortKey* radix_sort_pairs(SortKey keys[], SortKey temp[], int n) {
+    size_t (*count)[RADIX_BUCKETS] = (size_t(*)[RADIX_BUCKETS])tracked_calloc(RADIX_PASSES, sizeof(*count));
+    if (!count) {
+        fprintf(stderr, "Error: Memory allocation failed for Radix Sort histograms.\n");
+        return NULL;
+    }
+
+    // Pre-pass: histograms of every digit position at once
+    for (int i = 0; i < n; i++) {
+        uint64_t key = keys[i].key;
+        for (int d = 0; d < RADIX_PASSES; d++) {
+            count[d][(key >> (d * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+        }
+    }
+
+    SortKey* src = keys;
+    SortKey* dst = temp;
+    for (int d = 0; d < RADIX_PASSES; d++) {
+        int shift = d * RADIX_BITS;
+
+        // Every key shares this digit: the pass would not move anything
+        if (count[d][(src[0].key >> shift) & (RADIX_BUCKETS - 1)] == (size_t)n) continue;
+
+        size_t offset = 0;
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            size_t c = count[d][b];
+            count[d][b] = offset;
+            offset += c;
+        }
+
+        for (int i = 0; i < n; i++) {
+            dst[count[d][(src[i].key >> shift) & (RADIX_BUCKETS - 1)]++] = src[i];
+        }
+
+        SortKey* swap_buffer = src; src = dst; dst = swap_buffer;
+    }
+
+    tracked_free(count);
+    return src;
+}
+
+void radix_sort_with_extractor(Student arr[], int n, CompareFunc cmp, KeyExtractFunc extract, long long* comparisons) {
+    if (n < 2) return;
+
+    SortKey* keys = extract ? (SortKey*)tracked_malloc(sizeof(SortKey) * n * 2) : NULL;
+    if (!keys) {
+        merge_sort(arr, n, cmp, comparisons);
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (!extract(&arr[i], &keys[i].key)) {
+            tracked_free(keys);
+            merge_sort(arr, n, cmp, comparisons);
+            return;
+        }
+        keys[i].index = (uint32_t)i;
+    }
+
+    SortKey* sorted = radix_sort_pairs(keys, keys + n, n);
+    if (sorted) apply_permutation(arr, sorted, n);
+
+    tracked_free(keys);
+}
+
+// ID Ascending regardless of cmp (kept for the original Radix Sort (ID) rows)
+void radix_sort_id(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    (void)cmp;
+    radix_sort_with_extractor(arr, n, compare_id_asc, extract_key_id_asc, comparisons);
+    *comparisons = 0; // Radix sort is non-comparison based
+}
+
+// Any criterion with a packed key; comparisons stay 0 unless the merge_sort fallback runs
+void radix_sort_key(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    radix_sort_with_extractor(arr, n, cmp, key_extractor_for(cmp), comparisons);
+}
+
+
+// I. Tree Sort (A - Simple Binary Search Tree)
+
+typedef struct TreeNode {
+    Student data;
+    struct TreeNode* left;
+    struct TreeNode* right;
+} TreeNode;
+
+TreeNode* new_tree_node(Student s) {
+    TreeNode* temp = (TreeNode*)tracked_malloc(sizeof(TreeNode));
+    if (temp) {
+        temp->data = s;
+        temp->left = temp->right = NULL;
+    }
+    return temp;
+}
+
+TreeNode* insert_bst(TreeNode* node, Student s, CompareFunc cmp, long long* comparisons) {
+    if (node == NULL) return new_tree_node(s);
+
+    if (cmp(&s, &node->data, comparisons) < 0) {
+        node->left = insert_bst(node->left, s, cmp, comparisons);
+    }
+    else {
+        // If equal or greater, go to the right (for non-strict BST)
+        node->right = insert_bst(node->right, s, cmp, comparisons);
+    }
+    return node;
+}
+
+void inorder_bst(TreeNode* root, Student arr[], int* index) {
+    if (root != NULL) {
+        inorder_bst(root->left, arr, index);
+        arr[(*index)++] = root->data;
+        inorder_bst(root->right, arr, index);
+    }
+}
+
+void free_bst(TreeNode* root) {
+    if (root != NULL) {
+        free_bst(root->left);
+        free_bst(root->right);
+        tracked_free(root);
+    }
+}
+
+void tree_sort_basic(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    TreeNode* root = NULL;
+    for (int i = 0; i < n; i++) {
+        root = insert_bst(root, arr[i], cmp, comparisons);
+    }
+
+    int index = 0;
+    inorder_bst(root, arr, &index);
+
+    free_bst(root);
+}
+
+
+// I. Tree Sort (B - AVL Tree)
+// Self-balancing tree, so the height stays below 1.44 log2(n) even for presorted input.
+// Insertion is iterative: the search path is kept on a small stack and walked back to fix
+// heights and rotate. All nodes come from one arena of n nodes allocated up front; node i
+// stands for the i-th input record (records are read in place, never copied into nodes),
+// and the in-order walk yields the permutation that is applied to the records once.
+// Equal keys go to the right, so the sort is stable.
+#define AVL_MAX_HEIGHT 64 // 1.44 * log2(INT_MAX) < 46
+
+typedef struct {
+    int left;  // Arena indices, -1 for none
+    int right;
+    int height;
+} AvlNode;
+
+int avl_height(const AvlNode nodes[], int i) {
+    return i < 0 ? 0 : nodes[i].height;
+}
+
+void avl_update_height(AvlNode nodes[], int i) {
+    int hl = avl_height(nodes, nodes[i].left);
+    int hr = avl_height(nodes, nodes[i].right);
+    nodes[i].height = 1 + (hl > hr ? hl : hr);
+}
+
+int avl_rotate_right(AvlNode nodes[], int y) {
+    int x = nodes[y].left;
+    nodes[y].left = nodes[x].right;
+    nodes[x].right = y;
+    avl_update_height(nodes, y);
+    avl_update_height(nodes, x);
+    return x;
+}
+
+int avl_rotate_left(AvlNode nodes[], int x) {
+    int y = nodes[x].right;
+    nodes[x].right = nodes[y].left;
+    nodes[y].left = x;
+    avl_update_height(nodes, x);
+    avl_update_height(nodes, y);
+    return y;
+}
+
+// Restores the AVL property at node i; returns the new root of this subtree
+int avl_rebalance(AvlNode nodes[], int i) {
+    avl_update_height(nodes, i);
+    int balance = avl_height(nodes, nodes[i].left) - avl_height(nodes, nodes[i].right);
+
+    if (balance > 1) {
+        int l = nodes[i].left;
+        if (avl_height(nodes, nodes[l].left) < avl_height(nodes, nodes[l].right)) {
+            nodes[i].left = avl_rotate_left(nodes, l); // Left-Right case
+        }
+        return avl_rotate_right(nodes, i);
+    }
+    if (balance < -1) {
+        int r = nodes[i].right;
+        if (avl_height(nodes, nodes[r].right) < avl_height(nodes, nodes[r].left)) {
+            nodes[i].right = avl_rotate_right(nodes, r); // Right-Left case
+        }
+        return avl_rotate_left(nodes, i);
+    }
+    return i;
+}
+
+// Record represented by arena node i: base[i], or base[idx[i]] when sorting an index array
+#define AVL_RECORD(i) (&base[idx ? idx[i] : (uint32_t)(i)])
+
+// Inserts node k (already initialized as a leaf) and returns the new root
+int avl_insert(AvlNode nodes[], int root, int k, const Student* base, const uint32_t* idx, CompareFunc cmp, long long* comparisons) {
+    if (root < 0) return k;
+
+    int path[AVL_MAX_HEIGHT];
+    int went_left[AVL_MAX_HEIGHT];
+    int depth = 0;
+
+    int cur = root;
+    while (cur >= 0) {
+        path[depth] = cur;
+        went_left[depth] = cmp(AVL_RECORD(k), AVL_RECORD(cur), comparisons) < 0;
+        cur = went_left[depth] ? nodes[cur].left : nodes[cur].right;
+        depth++;
+    }
+    if (went_left[depth - 1]) nodes[path[depth - 1]].left = k;
+    else nodes[path[depth - 1]].right = k;
+
+    // Walk back up; once a subtree keeps its height, nothing above it changes
+    for (int d = depth - 1; d >= 0; d--) {
+        int node = path[d];
+        int old_height = nodes[node].height;
+        int sub = avl_rebalance(nodes, node);
+
+        if (d == 0) root = sub;
+        else if (went_left[d - 1]) nodes[path[d - 1]].left = sub;
+        else nodes[path[d - 1]].right = sub;
+
+        if (sub == node && nodes[node].height == old_height) break;
+    }
+    return root;
+}
+
+// Builds the tree over n records and writes the arena node ids in sorted order to order[]
+int avl_sort_order(const Student* base, const uint32_t* idx, int n, CompareFunc cmp, long long* comparisons, uint32_t order[]) {
+    AvlNode* nodes = (AvlNode*)tracked_malloc(sizeof(AvlNode) * (n > 0 ? n : 1));
+    if (!nodes) {
+        fprintf(stderr, "Error: Memory allocation failed for AVL node arena.\n");
+        return 0;
+    }
+
+    int root = -1;
+    for (int i = 0; i < n; i++) {
+        nodes[i].left = nodes[i].right = -1;
+        nodes[i].height = 1;
+        root = avl_insert(nodes, root, i, base, idx, cmp, comparisons);
+    }
+
+    // Iterative in-order walk
+    int stack[AVL_MAX_HEIGHT];
+    int top = 0, pos = 0, cur = root;
+    while (cur >= 0 || top > 0) {
+        while (cur >= 0) {
+            stack[top++] = cur;
+            cur = nodes[cur].left;
+        }
+        cur = stack[--top];
+        order[pos++] = (uint32_t)cur;
+        cur = nodes[cur].right;
+    }
+
+    tracked_free(nodes);
+    return 1;
+}
+
+// Same cycle-following as apply_permutation(), for a plain index array (perm is consumed)
+void apply_index_permutation(Student arr[], uint32_t perm[], int n) {
+    for (int i = 0; i < n; i++) {
+        if (perm[i] == (uint32_t)i) continue;
+
+        Student temp = arr[i];
+        int j = i;
+        while (1) {
+            int src = (int)perm[j];
+            perm[j] = (uint32_t)j;
+            if (src == i) {
+                arr[j] = temp;
+                break;
+            }
+            arr[j] = arr[src];
+            j = src;
+        }
+    }
+}
+
+void avl_tree_sort(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    uint32_t* order = (uint32_t*)tracked_malloc(sizeof(uint32_t) * (n > 0 ? n : 1));
+    if (!order) {
+        fprintf(stderr, "Error: Memory allocation failed for AVL Tree Sort order array.\n");
+        return;
+    }
+    if (avl_sort_order(arr, NULL, n, cmp, comparisons, order)) {
+        apply_index_permutation(arr, order, n);
+    }
+    tracked_free(order);
+}
+
+
+// J. Key-Extraction Sort (Packed 64-bit Keys)
+// Instead of moving 72-byte Student records through CompareFunc calls, each record is
+// reduced to an order-preserving 64-bit key. Comparing two keys as unsigned integers gives
+// the same result as the matching comparator (including the Korean > English > Math
+// tie-breaker), so the key+index pairs are sorted with a single integer compare and the
+// resulting permutation is applied to the records once at the end.
+
+// Bottom-up merge sort over key+index pairs (stable, one integer compare per step)
+void merge_sort_keys(SortKey keys[], int n, SortKey temp[], long long* comparisons) {
+    SortKey* src = keys;
+    SortKey* dst = temp;
+
+    for (int width = 1; width < n; width *= 2) {
+        for (int l = 0; l < n; l += 2 * width) {
+            int m = (l + width < n) ? l + width : n;
+            int r = (l + 2 * width < n) ? l + 2 * width : n;
+            int i = l, j = m, k = l;
+
+            while (i < m && j < r) {
+                (*comparisons)++;
+                if (src[i].key <= src[j].key) dst[k++] = src[i++];
+                else dst[k++] = src[j++];
+            }
+            while (i < m) dst[k++] = src[i++];
+            while (j < r) dst[k++] = src[j++];
+        }
+        SortKey* t = src; src = dst; dst = t;
+    }
+
+    if (src != keys) memcpy(keys, src, sizeof(SortKey) * n);
+}
+
+// Keys that fit in 32 bits (ID, GENDER) are sorted as single words, (key << 32) | position:
+// a tie on the key is broken by the original position, so the order stays stable. Blocks of
+// SORT_NETWORK_MAX_PAIRS words go through the bitonic network (AVX2 when available) and are
+// then merged bottom-up.
+void merge_sort_narrow_keys(uint64_t words[], int n, uint64_t temp[], long long* comparisons) {
+    for (int l = 0; l < n; l += SORT_NETWORK_MAX_PAIRS) {
+        int len = (n - l < SORT_NETWORK_MAX_PAIRS) ? n - l : SORT_NETWORK_MAX_PAIRS;
+        *comparisons += sort_network_u64(words + l, len);
+    }
+
+    uint64_t* src = words;
+    uint64_t* dst = temp;
+    for (int width = SORT_NETWORK_MAX_PAIRS; width < n; width *= 2) {
+        for (int l = 0; l < n; l += 2 * width) {
+            int m = (l + width < n) ? l + width : n;
+            int r = (l + 2 * width < n) ? l + 2 * width : n;
+            int i = l, j = m, k = l;
+
+            while (i < m && j < r) {
+                (*comparisons)++;
+                if (src[i] < src[j]) dst[k++] = src[i++];
+                else dst[k++] = src[j++];
+            }
+            while (i < m) dst[k++] = src[i++];
+            while (j < r) dst[k++] = src[j++];
+        }
+        uint64_t* t = src; src = dst; dst = t;
+    }
+
+    if (src != words) memcpy(words, src, sizeof(uint64_t) * n);
+}
+
+// Stable sort of key+index pairs; temp must hold n pairs
+void sort_key_pairs(SortKey keys[], int n, SortKey temp[], long long* comparisons) {
+    for (int i = 0; i < n; i++) {
+        if (keys[i].key > UINT32_MAX) {
+            merge_sort_keys(keys, n, temp, comparisons);
+            return;
+        }
+    }
+
+    // temp (16 bytes per pair) holds the packed words and their merge buffer
+    uint64_t* words = (uint64_t*)temp;
+    for (int i = 0; i < n; i++) words[i] = (keys[i].key << 32) | (uint32_t)i;
+    merge_sort_narrow_keys(words, n, words + n, comparisons);
+
+    // The merge buffer is free again: it holds the reordered indices while keys is rewritten
+    uint32_t* order = (uint32_t*)(words + n);
+    for (int i = 0; i < n; i++) order[i] = keys[(uint32_t)words[i]].index;
+    for (int i = 0; i < n; i++) {
+        keys[i].key = words[i] >> 32;
+        keys[i].index = order[i];
+    }
+}
+
+void key_sort(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    if (n < 2) return;
+
+    KeyExtractFunc extract = key_extractor_for(cmp);
+    if (!extract) {
+        merge_sort(arr, n, cmp, comparisons);
+        return;
+    }
+
+    SortKey* keys = (SortKey*)tracked_malloc(sizeof(SortKey) * n * 2);
+    if (!keys) {
+        fprintf(stderr, "Error: Memory allocation failed for Key Sort auxiliary array.\n");
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (!extract(&arr[i], &keys[i].key)) {
+            // A field is out of the packed range: use the comparator path instead
+            tracked_free(keys);
+            merge_sort(arr, n, cmp, comparisons);
+            return;
+        }
+        keys[i].index = (uint32_t)i;
+    }
+
+    sort_key_pairs(keys, n, keys + n, comparisons);
+    apply_permutation(arr, keys, n);
+
+    tracked_free(keys);
+}
+
+
+// K. Indirect (Index) Sorting
+// Each algorithm below sorts an array of uint32_t record indices instead of the records,
+// so a swap moves 4 bytes instead of sizeof(Student) and the loaded dataset is only read.
+// Several keys can be sorted over the same dataset at once; gather_students() produces the
+// sorted records when they are actually needed.
+
+typedef void (*IndexSortFunc)(const Student*, uint32_t[], int, CompareFunc, long long*);
+
+#define INDEX_CMP(a, b) cmp(&base[a], &base[b], comparisons)
+#define SWAP_INDEX(a, b) do { uint32_t temp_index = a; a = b; b = temp_index; } while (0)
+
+void init_index(uint32_t idx[], int n) {
+    for (int i = 0; i < n; i++) idx[i] = (uint32_t)i;
+}
+
+void gather_students(const Student* base, const uint32_t idx[], int n, Student out[]) {
+    for (int i = 0; i < n; i++) out[i] = base[idx[i]];
+}
+
+void bubble_sort_indirect(const Student* base, uint32_t idx[], int n, CompareFunc cmp, long long* comparisons) {
+    for (int i = 0; i < n - 1; i++) {
+        int swapped = 0;
+        for (int j = 0; j < n - 1 - i; j++) {
+            if (INDEX_CMP(idx[j], idx[j + 1]) > 0) {
+                SWAP_INDEX(idx[j], idx[j + 1]);
+                swapped = 1;
+            }
+        }
+        if (!swapped) break;
+    }
+}
+
+void selection_sort_indirect(const Student* base, uint32_t idx[], int n, CompareFunc cmp, long long* comparisons) {
+    for (int i = 0; i < n - 1; i++) {
+        int min_idx = i;
+        for (int j = i + 1; j < n; j++) {
+            if (INDEX_CMP(idx[j], idx[min_idx]) < 0) {
+                min_idx = j;
+            }
+        }
+        if (min_idx != i) {
+            SWAP_INDEX(idx[i], idx[min_idx]);
+        }
+    }
+}
+
+void insertion_sort_indirect(const Student* base, uint32_t idx[], int n, CompareFunc cmp, long long* comparisons) {
+    for (int i = 1; i < n; i++) {
+        uint32_t key = idx[i];
+        int j = i - 1;
+        while (j >= 0 && INDEX_CMP(idx[j], key) > 0) {
+            idx[j + 1] = idx[j];
+            j = j - 1;
+        }
+        idx[j + 1] = key;
+    }
+}
+
+// Shared gapped insertion pass for both shell sort variants
+void shell_pass_indirect(const Student* base, uint32_t idx[], int n, int gap, CompareFunc cmp, long long* comparisons) {
+    for (int i = gap; i < n; i++) {
+        uint32_t temp = idx[i];
+        int j;
+        for (j = i; j >= gap; j -= gap) {
+            if (INDEX_CMP(idx[j - gap], temp) > 0) {
+                idx[j] = idx[j - gap];
+            }
+            else {
+                break;
+            }
+        }
+        idx[j] = temp;
+    }
+}
+
+void shell_sort_basic_indirect(const Student* base, uint32_t idx[], int n, CompareFunc cmp, long long* comparisons) {
+    for (int gap = n / 2; gap > 0; gap /= 2) {
+        shell_pass_indirect(base, idx, n, gap, cmp, comparisons);
+    }
+}
+
+void shell_sort_improved_indirect(const Student* base, uint32_t idx[], int n, CompareFunc cmp, long long* comparisons) {
+    int gaps[20];
+    int h = 1;
+    int k = 0;
+    while (h < n) {
+        gaps[k++] = h;
+        h = h * 3 + 1;
+    }
+
+    for (int i = k - 1; i >= 0; i--) {
+        shell_pass_indirect(base, idx, n, gaps[i], cmp, comparisons);
+    }
+}
+
+int partition_basic_indirect(const Student* base, uint32_t idx[], int low, int high, CompareFunc cmp, long long* comparisons) {
+    uint32_t pivot = idx[high];
+    int i = (low - 1);
+
+    for (int j = low; j <= high - 1; j++) {
+        if (INDEX_CMP(idx[j], pivot) < 0) {
+            i++;
+            SWAP_INDEX(idx[i], idx[j]);
+        }
+    }
+    SWAP_INDEX(idx[i + 1], idx[high]);
+    return (i + 1);
+}
+
+void quick_sort_basic_indirect_recursive(const Student* base, uint32_t idx[], int low, int high, CompareFunc cmp, long long* comparisons) {
+    while (low < high) { // Smaller side first, as in quick_sort_basic_recursive()
+        int pi = partition_basic_indirect(base, idx, low, high, cmp, comparisons);
+        if (pi - low < high - pi) {
+            quick_sort_basic_indirect_recursive(base, idx, low, pi - 1, cmp, comparisons);
+            low = pi + 1;
+        }
+        else {
+            quick_sort_basic_indirect_recursive(base, idx, pi + 1, high, cmp, comparisons);
+            high = pi - 1;
+        }
+    }
+}
+
+void quick_sort_basic_indirect(const Student* base, uint32_t idx[], int n, CompareFunc cmp, long long* comparisons) {
+    quick_sort_basic_indirect_recursive(base, idx, 0, n - 1, cmp, comparisons);
+}
+
+int partition_improved_indirect(const Student* base, uint32_t idx[], int low, int high, CompareFunc cmp, long long* comparisons) {
+    // Median-of-three on the referenced records, same steps as median_of_three()
+    int mid = low + (high - low) / 2;
+    if (INDEX_CMP(idx[low], idx[mid]) > 0) SWAP_INDEX(idx[low], idx[mid]);
+    if (INDEX_CMP(idx[low], idx[high]) > 0) SWAP_INDEX(idx[low], idx[high]);
+    if (INDEX_CMP(idx[mid], idx[high]) > 0) SWAP_INDEX(idx[mid], idx[high]);
+    SWAP_INDEX(idx[mid], idx[low]);
+
+    uint32_t pivot = idx[low];
+    int i = low + 1;
+    int j = high;
+
+    while (1) {
+        while (i <= high && INDEX_CMP(idx[i], pivot) < 0) i++;
+        while (INDEX_CMP(idx[j], pivot) > 0) j--;
+
+        if (i > j) break;
+        SWAP_INDEX(idx[i], idx[j]);
+        i++;
+        j--;
+    }
+    SWAP_INDEX(idx[low], idx[j]);
+    return j;
+}
+
+void quick_sort_improved_indirect_recursive(const Student* base, uint32_t idx[], int low, int high, CompareFunc cmp, long long* comparisons) {
+    while (low < high) { // Smaller side first, as in quick_sort_improved_recursive()
+        int pi = partition_improved_indirect(base, idx, low, high, cmp, comparisons);
+        if (pi - low < high - pi) {
+            quick_sort_improved_indirect_recursive(base, idx, low, pi - 1, cmp, comparisons);
+            low = pi + 1;
+        }
+        else {
+            quick_sort_improved_indirect_recursive(base, idx, pi + 1, high, cmp, comparisons);
+            high = pi - 1;
+        }
+    }
+}
+
+void quick_sort_improved_indirect(const Student* base, uint32_t idx[], int n, CompareFunc cmp, long long* comparisons) {
+    quick_sort_improved_indirect_recursive(base, idx, 0, n - 1, cmp, comparisons);
+}
+
+void max_heapify_indirect(const Student* base, uint32_t idx[], int n, int i, CompareFunc cmp, long long* comparisons) {
+    int largest = i;
+    int left = 2 * i + 1;
+    int right = 2 * i + 2;
+
+    if (left < n && INDEX_CMP(idx[left], idx[largest]) > 0)
+        largest = left;
+
+    if (right < n && INDEX_CMP(idx[right], idx[largest]) > 0)
+        largest = right;
+
+    if (largest != i) {
+        SWAP_INDEX(idx[i], idx[largest]);
+        max_heapify_indirect(base, idx, n, largest, cmp, comparisons);
+    }
+}
+
+void heap_sort_indirect(const Student* base, uint32_t idx[], int n, CompareFunc cmp, long long* comparisons) {
+    for (int i = n / 2 - 1; i >= 0; i--)
+        max_heapify_indirect(base, idx, n, i, cmp, comparisons);
+
+    for (int i = n - 1; i > 0; i--) {
+        SWAP_INDEX(idx[0], idx[i]);
+        max_heapify_indirect(base, idx, i, 0, cmp, comparisons);
+    }
+}
+
+// Only the left half is copied out; the right half is merged in place from idx.
+void merge_indirect(const Student* base, uint32_t idx[], int l, int m, int r, CompareFunc cmp, long long* comparisons, uint32_t temp_idx[]) {
+    int n1 = m - l + 1;
+    memcpy(temp_idx, &idx[l], sizeof(uint32_t) * n1);
+
+    int i = 0, j = m + 1, k = l;
+    while (i < n1 && j <= r) {
+        // Stable property: use <= 0
+        if (INDEX_CMP(temp_idx[i], idx[j]) <= 0) {
+            idx[k++] = temp_idx[i++];
+        }
+        else {
+            idx[k++] = idx[j++];
+        }
+    }
+    while (i < n1) idx[k++] = temp_idx[i++];
+}
+
+void merge_sort_indirect_recursive(const Student* base, uint32_t idx[], int l, int r, CompareFunc cmp, long long* comparisons, uint32_t temp_idx[]) {
+    if (l < r) {
+        int m = l + (r - l) / 2;
+
+        merge_sort_indirect_recursive(base, idx, l, m, cmp, comparisons, temp_idx);
+        merge_sort_indirect_recursive(base, idx, m + 1, r, cmp, comparisons, temp_idx);
+
+        merge_indirect(base, idx, l, m, r, cmp, comparisons, temp_idx);
+    }
+}
+
+void merge_sort_indirect(const Student* base, uint32_t idx[], int n, CompareFunc cmp, long long* comparisons) {
+    uint32_t* temp_idx = (uint32_t*)tracked_malloc(sizeof(uint32_t) * (n / 2 + 1));
+    if (!temp_idx) {
+        fprintf(stderr, "Error: Memory allocation failed for Merge Sort auxiliary index array.\n");
+        return;
+    }
+    merge_sort_indirect_recursive(base, idx, 0, n - 1, cmp, comparisons, temp_idx);
+    tracked_free(temp_idx);
+}
+
+// Radix sort over indices: the key+index pairs carry the dataset positions, so the
+// sorted pairs are the result and no record is moved
+void radix_sort_key_indirect(const Student* base, uint32_t idx[], int n, CompareFunc cmp, long long* comparisons) {
+    if (n < 2) return;
+
+    KeyExtractFunc extract = key_extractor_for(cmp);
+    SortKey* keys = extract ? (SortKey*)tracked_malloc(sizeof(SortKey) * n * 2) : NULL;
+    if (!keys) {
+        merge_sort_indirect(base, idx, n, cmp, comparisons);
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (!extract(&base[idx[i]], &keys[i].key)) {
+            tracked_free(keys);
+            merge_sort_indirect(base, idx, n, cmp, comparisons);
+            return;
+        }
+        keys[i].index = idx[i];
+    }
+
+    SortKey* sorted = radix_sort_pairs(keys, keys + n, n);
+    if (sorted) {
+        for (int i = 0; i < n; i++) idx[i] = sorted[i].index;
+    }
+
+    tracked_free(keys);
+}
+
+void radix_sort_id_indirect(const Student* base, uint32_t idx[], int n, CompareFunc cmp, long long* comparisons) {
+    (void)cmp;
+    radix_sort_key_indirect(base, idx, n, compare_id_asc, comparisons);
+    *comparisons = 0; // Radix sort is non-comparison based
+}
+
+typedef struct IndexTreeNode {
+    uint32_t index;
+    struct IndexTreeNode* left;
+    struct IndexTreeNode* right;
+} IndexTreeNode;
+
+IndexTreeNode* insert_bst_indirect(IndexTreeNode* node, const Student* base, uint32_t index, CompareFunc cmp, long long* comparisons) {
+    if (node == NULL) {
+        IndexTreeNode* temp = (IndexTreeNode*)tracked_malloc(sizeof(IndexTreeNode));
+        if (temp) {
+            temp->index = index;
+            temp->left = temp->right = NULL;
+        }
+        return temp;
+    }
+
+    if (INDEX_CMP(index, node->index) < 0) {
+        node->left = insert_bst_indirect(node->left, base, index, cmp, comparisons);
+    }
+    else {
+        node->right = insert_bst_indirect(node->right, base, index, cmp, comparisons);
+    }
+    return node;
+}
+
+void inorder_bst_indirect(IndexTreeNode* root, uint32_t idx[], int* pos) {
+    if (root != NULL) {
+        inorder_bst_indirect(root->left, idx, pos);
+        idx[(*pos)++] = root->index;
+        inorder_bst_indirect(root->right, idx, pos);
+    }
+}
+
+void free_bst_indirect(IndexTreeNode* root) {
+    if (root != NULL) {
+        free_bst_indirect(root->left);
+        free_bst_indirect(root->right);
+        tracked_free(root);
+    }
+}
+
+void tree_sort_basic_indirect(const Student* base, uint32_t idx[], int n, CompareFunc cmp, long long* comparisons) {
+    IndexTreeNode* root = NULL;
+    for (int i = 0; i < n; i++) {
+        root = insert_bst_indirect(root, base, idx[i], cmp, comparisons);
+    }
+
+    int pos = 0;
+    inorder_bst_indirect(root, idx, &pos);
+
+    free_bst_indirect(root);
+}
+
+void avl_tree_sort_indirect(const Student* base, uint32_t idx[], int n, CompareFunc cmp, long long* comparisons) {
+    uint32_t* order = (uint32_t*)tracked_malloc(sizeof(uint32_t) * (n > 0 ? n : 1));
+    if (!order) {
+        fprintf(stderr, "Error: Memory allocation failed for AVL Tree Sort order array.\n");
+        return;
+    }
+    if (avl_sort_order(base, idx, n, cmp, comparisons, order)) {
+        // order[] holds positions in idx; map them to record indices
+        for (int i = 0; i < n; i++) order[i] = idx[order[i]];
+        memcpy(idx, order, sizeof(uint32_t) * n);
+    }
+    tracked_free(order);
+}
+
+// The key-extraction sort already orders key+index pairs; here the permutation is the result.
+void key_sort_indirect(const Student* base, uint32_t idx[], int n, CompareFunc cmp, long long* comparisons) {
+    if (n < 2) return;
+
+    KeyExtractFunc extract = key_extractor_for(cmp);
+    SortKey* keys = extract ? (SortKey*)tracked_malloc(sizeof(SortKey) * n * 2) : NULL;
+    if (!keys) {
+        merge_sort_indirect(base, idx, n, cmp, comparisons);
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (!extract(&base[idx[i]], &keys[i].key)) {
+            tracked_free(keys);
+            merge_sort_indirect(base, idx, n, cmp, comparisons);
+            return;
+        }
+        keys[i].index = idx[i];
+    }
+
+    sort_key_pairs(keys, n, keys + n, comparisons);
+    for (int i = 0; i < n; i++) idx[i] = keys[i].index;
+
+    tracked_free(keys);
+}
+
+
+// L. Parallel Merge Sort (pthreads)
+// The array is cut into T chunks that are merge-sorted concurrently, then log2(T) rounds
+// of pairwise merges follow. Each round splits the *output* into T equal segments; a
+// thread finds where its segment starts in the two input runs with a co-ranking (merge
+// path) binary search and merges just that segment, so the last merges are as parallel
+// as the first. Ties always take the left run first, which keeps the sort stable. Every
+// thread counts into its own counter and the counters are summed at the end.
+
+#define PARALLEL_MERGE_MIN_CHUNK 4096 // Smaller inputs are not worth a thread each
+#define MAX_SORT_THREADS 64
+
+int resolve_thread_count(void) {
+    int threads = sort_thread_count;
+#if HAVE_PTHREADS
+    if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (threads < 1) threads = 1;
+    if (threads > MAX_SORT_THREADS) threads = MAX_SORT_THREADS;
+    return threads;
+}
+
+// Number of elements of a[0..na) that come before output position k in the stable merge of
+// a and b (the rest of the k outputs come from b).
+int merge_co_rank(int k, const Student a[], int na, const Student b[], int nb, CompareFunc cmp, long long* comparisons) {
+    int i = k < na ? k : na;
+    int j = k - i;
+    int i_low = k - nb > 0 ? k - nb : 0;
+    int j_low = k - na > 0 ? k - na : 0;
+
+    while (1) {
+        if (i > 0 && j < nb && cmp(&a[i - 1], &b[j], comparisons) > 0) {
+            // a[i - 1] belongs after b[j]: take fewer from a
+            int delta = (i - i_low + 1) / 2;
+            j_low = j;
+            i -= delta;
+            j += delta;
+        }
+        else if (j > 0 && i < na && cmp(&b[j - 1], &a[i], comparisons) >= 0) {
+            // a[i] belongs before b[j - 1] (ties go to a): take more from a
+            int delta = (j - j_low + 1) / 2;
+            i_low = i;
+            i += delta;
+            j -= delta;
+        }
+        else {
+            return i;
+        }
+    }
+}
+
+typedef struct {
+    Student* src;
+    Student* dst;
+    Student* temp;
+    int n;
+    int width; // Length of the sorted runs being merged (0 = initial chunk sort)
+    int lo;    // Chunk or output segment handled by this task
+    int hi;
+    CompareFunc cmp;
+    long long comparisons;
+    long long char_inspections; // The task thread's count (char_inspections is thread-local)
+} MergeTask;
+
+// Merges output positions [task->lo, task->hi) of every run pair that overlaps them
+void merge_segment_task(MergeTask* task) {
+    int pair_len = task->width * 2;
+    int first_pair = task->lo / pair_len * pair_len;
+
+    for (int l = first_pair; l < task->hi; l += pair_len) {
+        int m = l + task->width < task->n ? l + task->width : task->n;
+        int r = l + pair_len < task->n ? l + pair_len : task->n;
+        const Student* a = task->src + l;
+        const Student* b = task->src + m;
+        int na = m - l, nb = r - m;
+
+        int k_begin = (task->lo > l ? task->lo : l) - l;
+        int k_end = (task->hi < r ? task->hi : r) - l;
+        int i = merge_co_rank(k_begin, a, na, b, nb, task->cmp, &task->comparisons);
+        int j = k_begin - i;
+        int i_end = merge_co_rank(k_end, a, na, b, nb, task->cmp, &task->comparisons);
+        int j_end = k_end - i_end;
+
+        Student* out = task->dst + l + k_begin;
+        while (i < i_end && j < j_end) {
+            // Stable property: use <= 0
+            if (task->cmp(&a[i], &b[j], &task->comparisons) <= 0) *out++ = a[i++];
+            else *out++ = b[j++];
+        }
+        while (i < i_end) *out++ = a[i++];
+        while (j < j_end) *out++ = b[j++];
+    }
+}
+
+#if HAVE_PTHREADS
+void* merge_task_main(void* arg) {
+    MergeTask* task = (MergeTask*)arg;
+    long long caller_inspections = char_inspections; // Nonzero when run on the calling thread
+    char_inspections = 0;
+    if (task->width == 0) {
+        merge_sort_recursive(task->src, task->lo, task->hi - 1, task->cmp, &task->comparisons, task->temp + task->lo);
+    }
+    else {
+        merge_segment_task(task);
+    }
+    task->char_inspections = char_inspections;
+    char_inspections = caller_inspections;
+    return NULL;
+}
+
+// Runs one phase with a thread per task; the calling thread takes task 0 itself
+void run_merge_tasks(MergeTask tasks[], int count) {
+    pthread_t threads[MAX_SORT_THREADS];
+    int started[MAX_SORT_THREADS] = { 0 };
+
+    for (int t = 1; t < count; t++) {
+        started[t] = pthread_create(&threads[t], NULL, merge_task_main, &tasks[t]) == 0;
+        if (!started[t]) merge_task_main(&tasks[t]); // Could not spawn: run it here
+    }
+    merge_task_main(&tasks[0]);
+    for (int t = 1; t < count; t++) {
+        if (started[t]) pthread_join(threads[t], NULL);
+    }
+    for (int t = 0; t < count; t++) char_inspections += tasks[t].char_inspections;
+}
+#endif
+
+void merge_sort_parallel(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+#if HAVE_PTHREADS
+    // Power-of-two thread count so the chunks pair up evenly in the merge rounds
+    int threads = 1;
+    int max_threads = resolve_thread_count();
+    while (threads * 2 <= max_threads && n / (threads * 2) >= PARALLEL_MERGE_MIN_CHUNK) threads *= 2;
+
+    if (threads == 1) {
+        merge_sort(arr, n, cmp, comparisons);
+        return;
+    }
+
+    Student* temp = (Student*)tracked_malloc(sizeof(Student) * n);
+    if (!temp) {
+        fprintf(stderr, "Error: Memory allocation failed for Parallel Merge Sort auxiliary array.\n");
+        return;
+    }
+
+    MergeTask tasks[MAX_SORT_THREADS];
+    int chunk = (n + threads - 1) / threads;
+
+    // Phase 1: sort each chunk independently (chunk boundaries are multiples of chunk)
+    for (int t = 0; t < threads; t++) {
+        MergeTask task = { arr, NULL, temp, n, 0, t * chunk, (t + 1) * chunk < n ? (t + 1) * chunk : n, cmp, 0, 0 };
+        tasks[t] = task;
+    }
+    run_merge_tasks(tasks, threads);
+    for (int t = 0; t < threads; t++) *comparisons += tasks[t].comparisons;
+
+    // Phase 2: merge rounds, ping-ponging between arr and temp
+    Student* src = arr;
+    Student* dst = temp;
+    for (int width = chunk; width < n; width *= 2) {
+        for (int t = 0; t < threads; t++) {
+            MergeTask task = { src, dst, NULL, n, width, (int)((long long)n * t / threads), (int)((long long)n * (t + 1) / threads), cmp, 0, 0 };
+            tasks[t] = task;
+        }
+        run_merge_tasks(tasks, threads);
+        for (int t = 0; t < threads; t++) *comparisons += tasks[t].comparisons;
+
+        Student* swap_buffer = src; src = dst; dst = swap_buffer;
+    }
+
+    if (src != arr) memcpy(arr, src, sizeof(Student) * n);
+    tracked_free(temp);
+#else
+    merge_sort(arr, n, cmp, comparisons);
+#endif
+}
+
+// M. Comparator-Specialized Sorts
+// sort_template.h is included once per comparator below, generating spec_<algorithm>_<key>()
+// functions whose comparison is a direct call to an inline comparator instead of an indirect
+// CompareFunc call. The *_specialized() entry points look up the copy matching the
+// CompareFunc they are given, so they drop into the same test table as the generic sorts;
+// unknown comparators fall back to the generic version.
+#if SORT_COUNT_COMPARISONS
+#define COUNT_COMPARISON(comparisons) ((*(comparisons))++)
+#else
+#define COUNT_COMPARISON(comparisons) ((void)(comparisons))
+#endif
+
+static inline int inline_compare_grades(const Student* a, const Student* b, long long* comparisons) {
+    COUNT_COMPARISON(comparisons);
+    if (a->korean != b->korean) return b->korean - a->korean;
+    COUNT_COMPARISON(comparisons);
+    if (a->english != b->english) return b->english - a->english;
+    COUNT_COMPARISON(comparisons);
+    if (a->math != b->math) return b->math - a->math;
+    return 0;
+}
+
+static inline int inline_compare_id_asc(const Student* a, const Student* b, long long* comparisons) {
+    COUNT_COMPARISON(comparisons);
+    return a->id - b->id;
+}
+
+static inline int inline_compare_id_desc(const Student* a, const Student* b, long long* comparisons) {
+    COUNT_COMPARISON(comparisons);
+    return b->id - a->id;
+}
+
+static inline int inline_compare_name_asc(const Student* a, const Student* b, long long* comparisons) {
+    COUNT_COMPARISON(comparisons);
+    return compare_name_bytes(a->name, b->name);
+}
+
+static inline int inline_compare_name_desc(const Student* a, const Student* b, long long* comparisons) {
+    COUNT_COMPARISON(comparisons);
+    return compare_name_bytes(b->name, a->name);
+}
+
+static inline int inline_compare_gender_asc(const Student* a, const Student* b, long long* comparisons) {
+    COUNT_COMPARISON(comparisons);
+    return a->gender - b->gender;
+}
+
+static inline int inline_compare_gender_desc(const Student* a, const Student* b, long long* comparisons) {
+    COUNT_COMPARISON(comparisons);
+    return b->gender - a->gender;
+}
+
+static inline int inline_compare_total_asc(const Student* a, const Student* b, long long* comparisons) {
+    COUNT_COMPARISON(comparisons);
+    if (a->total_grade != b->total_grade) return a->total_grade - b->total_grade;
+    return inline_compare_grades(a, b, comparisons);
+}
+
+static inline int inline_compare_total_desc(const Student* a, const Student* b, long long* comparisons) {
+    COUNT_COMPARISON(comparisons);
+    if (a->total_grade != b->total_grade) return b->total_grade - a->total_grade;
+    return inline_compare_grades(a, b, comparisons);
+}
+
+#define SORT_SUFFIX id_asc
+#define SORT_CMP inline_compare_id_asc
+#include "sort_template.h"
+
+#define SORT_SUFFIX id_desc
+#define SORT_CMP inline_compare_id_desc
+#include "sort_template.h"
+
+#define SORT_SUFFIX name_asc
+#define SORT_CMP inline_compare_name_asc
+#include "sort_template.h"
+
+#define SORT_SUFFIX name_desc
+#define SORT_CMP inline_compare_name_desc
+#include "sort_template.h"
+
+#define SORT_SUFFIX gender_asc
+#define SORT_CMP inline_compare_gender_asc
+#include "sort_template.h"
+
+#define SORT_SUFFIX gender_desc
+#define SORT_CMP inline_compare_gender_desc
+#include "sort_template.h"
+
+#define SORT_SUFFIX total_asc
+#define SORT_CMP inline_compare_total_asc
+#include "sort_template.h"
+
+#define SORT_SUFFIX total_desc
+#define SORT_CMP inline_compare_total_desc
+#include "sort_template.h"
+
+typedef void (*SortFunc)(Student[], int, CompareFunc, long long*);
+
+typedef struct {
+    CompareFunc cmp; // Generic comparator the specializations stand in for
+    SortFunc bubble;
+    SortFunc selection;
+    SortFunc insertion;
+    SortFunc shell;
+    SortFunc heap;
+    SortFunc intro;
+    SortFunc merge;
+} SpecializedSorts;
+
+#define SPECIALIZED_ENTRY(key) \
+    { compare_##key, spec_bubble_sort_##key, spec_selection_sort_##key, spec_insertion_sort_##key, \
+      spec_shell_sort_##key, spec_heap_sort_##key, spec_intro_sort_##key, spec_merge_sort_##key }
+
+const SpecializedSorts specialized_sorts[] = {
+    SPECIALIZED_ENTRY(id_asc),
+    SPECIALIZED_ENTRY(id_desc),
+    SPECIALIZED_ENTRY(name_asc),
+    SPECIALIZED_ENTRY(name_desc),
+    SPECIALIZED_ENTRY(gender_asc),
+    SPECIALIZED_ENTRY(gender_desc),
+    SPECIALIZED_ENTRY(total_asc),
+    SPECIALIZED_ENTRY(total_desc),
+};
+
+const SpecializedSorts* specialized_sorts_for(CompareFunc cmp) {
+    int count = (int)(sizeof(specialized_sorts) / sizeof(specialized_sorts[0]));
+    for (int i = 0; i < count; i++) {
+        if (specialized_sorts[i].cmp == cmp) return &specialized_sorts[i];
+    }
+    return NULL;
+}
+
+// Entry points with the generic signature: the specialized copy for cmp, or the generic sort
+#define DEFINE_SPECIALIZED_SORT(name, field, generic) \
+    void name(Student arr[], int n, CompareFunc cmp, long long* comparisons) { \
+        const SpecializedSorts* spec = specialized_sorts_for(cmp); \
+        if (spec) spec->field(arr, n, cmp, comparisons); \
+        else generic(arr, n, cmp, comparisons); \
+    }
+
+DEFINE_SPECIALIZED_SORT(bubble_sort_specialized, bubble, bubble_sort)
+DEFINE_SPECIALIZED_SORT(selection_sort_specialized, selection, selection_sort)
+DEFINE_SPECIALIZED_SORT(insertion_sort_specialized, insertion, insertion_sort)
+DEFINE_SPECIALIZED_SORT(shell_sort_specialized, shell, shell_sort_improved)
+DEFINE_SPECIALIZED_SORT(heap_sort_specialized, heap, heap_sort)
+DEFINE_SPECIALIZED_SORT(intro_sort_specialized, intro, intro_sort)
+DEFINE_SPECIALIZED_SORT(merge_sort_specialized, merge, merge_sort)
+
+
+// N. Sort Specifications (Composite Byte Keys, MSD Radix)
+// A SortSpec is a list of (column, direction) pairs parsed from text such as
+// "gender:asc,total:desc,name:asc", so a new ordering needs no new comparator. A spec is
+// used two ways:
+//   - compare_by_spec() compares two records column by column, for the comparison sorts
+//     (through compare_active_spec, which reads the global active_sort_spec);
+//   - encode_spec_key() writes an order-preserving byte string per record: signed ints as
+//     big-endian with the sign bit flipped, names NUL-padded to a fixed width, and every
+//     byte of a descending column inverted, so memcmp() on two keys gives the spec's order.
+//     The record index is appended, which makes every key unique and the sort stable.
+// radix_sort_spec() sorts those keys with an American flag sort (in-place MSD radix on a
+// byte at a time) and finishes buckets of at most SPEC_RADIX_CUTOFF keys with insertion
+// sort on the remaining bytes.
+#define SORT_SPEC_MAX_KEYS 8
+#define DEFAULT_ORDER_SPEC "gender:asc,total:desc,name:asc" // Ordering of the table's multi-column rows
+#define SORT_SPEC_TEXT_LEN 128
+#define SPEC_RADIX_CUTOFF 32
+
+typedef enum {
+    COLUMN_ID,
+    COLUMN_NAME,
+    COLUMN_GENDER,
+    COLUMN_KOREAN,
+    COLUMN_ENGLISH,
+    COLUMN_MATH,
+    COLUMN_TOTAL,
+    COLUMN_COUNT
+} SortColumn;
+
+static const char* const sort_column_names[COLUMN_COUNT] = {
+    "id", "name", "gender", "korean", "english", "math", "total"
+};
+
+typedef struct {
+    SortColumn column;
+    int descending;
+} SortSpecKey;
+
+typedef struct {
+    SortSpecKey keys[SORT_SPEC_MAX_KEYS];
+    int count;
+    size_t key_bytes; // Encoded key length, including the 4-byte record index
+} SortSpec;
+
+SortSpec active_sort_spec; // Order used by compare_active_spec (--order)
+char active_sort_spec_text[SORT_SPEC_TEXT_LEN];
+
+size_t sort_column_width(SortColumn column) {
+    if (column == COLUMN_NAME) return MAX_NAME_LEN;
+    if (column == COLUMN_GENDER) return 1;
+    return 4;
+}
+
+// Parses "column[:asc|desc],..." (asc by default); returns 0 after printing an error
+int parse_sort_spec(const char* text, SortSpec* spec) {
+    memset(spec, 0, sizeof(*spec));
+    const char* p = text;
+
+    while (*p) {
+        const char* comma = strchr(p, ',');
+        size_t len = comma ? (size_t)(comma - p) : strlen(p);
+        while (len > 0 && (*p == ' ' || *p == '\t')) { p++; len--; }
+        while (len > 0 && (p[len - 1] == ' ' || p[len - 1] == '\t')) len--;
+
+        const char* colon = memchr(p, ':', len);
+        size_t name_len = colon ? (size_t)(colon - p) : len;
+        int column = -1;
+        for (int c = 0; c < COLUMN_COUNT; c++) {
+            if (strlen(sort_column_names[c]) == name_len && strncmp(sort_column_names[c], p, name_len) == 0) column = c;
+        }
+        if (column < 0) {
+            fprintf(stderr, "Error: Unknown sort column '%.*s' in '%s'.\n", (int)name_len, p, text);
+            return 0;
+        }
+
+        int descending = 0;
+        if (colon) {
+            const char* dir = colon + 1;
+            size_t dir_len = len - name_len - 1;
+            if (dir_len == 4 && strncmp(dir, "desc", 4) == 0) descending = 1;
+            else if (!(dir_len == 3 && strncmp(dir, "asc", 3) == 0)) {
+                fprintf(stderr, "Error: Sort direction must be asc or desc in '%s'.\n", text);
+                return 0;
+            }
+        }
+
+        for (int k = 0; k < spec->count; k++) {
+            if (spec->keys[k].column == (SortColumn)column) {
+                fprintf(stderr, "Error: Column '%s' appears twice in '%s'.\n", sort_column_names[column], text);
+                return 0;
+            }
+        }
+        if (spec->count == SORT_SPEC_MAX_KEYS) {
+            fprintf(stderr, "Error: At most %d sort columns in '%s'.\n", SORT_SPEC_MAX_KEYS, text);
+            return 0;
+        }
+        spec->keys[spec->count].column = (SortColumn)column;
+        spec->keys[spec->count].descending = descending;
+        spec->count++;
+        spec->key_bytes += sort_column_width((SortColumn)column);
+
+        if (!comma) break;
+        p = comma + 1;
+    }
+
+    if (spec->count == 0) {
+        fprintf(stderr, "Error: Empty sort specification.\n");
+        return 0;
+    }
+    spec->key_bytes += sizeof(uint32_t);
+    return 1;
+}
+
+int spec_column_int(const Student* s, SortColumn column) {
+    switch (column) {
+    case COLUMN_ID: return s->id;
+    case COLUMN_KOREAN: return s->korean;
+    case COLUMN_ENGLISH: return s->english;
+    case COLUMN_MATH: return s->math;
+    default: return s->total_grade;
+    }
+}
+
+// Gender as an unsigned byte with the order of the char comparison in compare_gender_asc
+unsigned char spec_gender_byte(char gender) {
+#if CHAR_MIN < 0
+    return (unsigned char)gender ^ 0x80;
+#else
+    return (unsigned char)gender;
+#endif
+}
+
+// Counts one comparison per column examined, like the hand-written tie-breaker chains
+int compare_by_spec(const SortSpec* spec, const Student* a, const Student* b, long long* comparisons) {
+    for (int k = 0; k < spec->count; k++) {
+        SortColumn column = spec->keys[k].column;
+        int c;
+        (*comparisons)++;
+        if (column == COLUMN_NAME) {
+            c = compare_name_bytes(a->name, b->name);
+        }
+        else if (column == COLUMN_GENDER) {
+            c = (int)spec_gender_byte(a->gender) - (int)spec_gender_byte(b->gender);
+        }
+        else {
+            int x = spec_column_int(a, column);
+            int y = spec_column_int(b, column);
+            c = (x > y) - (x < y);
+        }
+        if (c != 0) return spec->keys[k].descending ? -c : c;
+    }
+    return 0;
+}
+
+int compare_active_spec(const Student* a, const Student* b, long long* comparisons) {
+    return compare_by_spec(&active_sort_spec, a, b, comparisons);
+}
+
+// Writes spec->key_bytes bytes for record s at position index
+void encode_spec_key(const SortSpec* spec, const Student* s, uint32_t index, unsigned char* out) {
+    for (int k = 0; k < spec->count; k++) {
+        SortColumn column = spec->keys[k].column;
+        size_t width = sort_column_width(column);
+
+        if (column == COLUMN_NAME) {
+            size_t len = strnlen(s->name, MAX_NAME_LEN);
+            char_inspections += (long long)(len < MAX_NAME_LEN ? len + 1 : len);
+            memcpy(out, s->name, len);
+            memset(out + len, 0, width - len); // A prefix sorts before its extensions
+        }
+        else if (column == COLUMN_GENDER) {
+            out[0] = spec_gender_byte(s->gender);
+        }
+        else {
+            uint32_t v = SIGNED_KEY(spec_column_int(s, column));
+            out[0] = (unsigned char)(v >> 24);
+            out[1] = (unsigned char)(v >> 16);
+            out[2] = (unsigned char)(v >> 8);
+            out[3] = (unsigned char)v;
+        }
+        if (spec->keys[k].descending) {
+            for (size_t i = 0; i < width; i++) out[i] = (unsigned char)~out[i];
+        }
+        out += width;
+    }
+    out[0] = (unsigned char)(index >> 24);
+    out[1] = (unsigned char)(index >> 16);
+    out[2] = (unsigned char)(index >> 8);
+    out[3] = (unsigned char)index;
+}
+
+// Standard comparators as specs; the TOTAL tie-breakers rank higher grades first either way
+int sort_spec_for(CompareFunc cmp, SortSpec* spec) {
+    const char* text = NULL;
+    if (cmp == compare_id_asc) text = "id:asc";
+    else if (cmp == compare_id_desc) text = "id:desc";
+    else if (cmp == compare_name_asc) text = "name:asc";
+    else if (cmp == compare_name_desc) text = "name:desc";
+    else if (cmp == compare_gender_asc) text = "gender:asc";
+    else if (cmp == compare_gender_desc) text = "gender:desc";
+    else if (cmp == compare_total_asc) text = "total:asc,korean:desc,english:desc,math:desc";
+    else if (cmp == compare_total_desc) text = "total:desc,korean:desc,english:desc,math:desc";
+    else if (cmp == compare_active_spec && active_sort_spec.count > 0) {
+        *spec = active_sort_spec;
+        return 1;
+    }
+    return text != NULL && parse_sort_spec(text, spec);
+}
+
+// American flag sort of idx[0, n) by the keys' bytes from depth on
+void spec_radix_sort_range(const unsigned char* keys, size_t stride, uint32_t idx[], int n, size_t depth, long long* comparisons) {
+    while (n > SPEC_RADIX_CUTOFF && depth < stride) {
+        int count[RADIX_BUCKETS] = { 0 };
+        for (int i = 0; i < n; i++) count[keys[(size_t)idx[i] * stride + depth]]++;
+
+        // Every key shares this byte: move on without permuting
+        if (count[keys[(size_t)idx[0] * stride + depth]] == n) {
+            depth++;
+            continue;
+        }
+
+        int start[RADIX_BUCKETS];
+        int next[RADIX_BUCKETS];
+        int offset = 0;
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            start[b] = next[b] = offset;
+            offset += count[b];
+        }
+
+        // Cycle each misplaced index into the next free slot of its bucket
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            int end = start[b] + count[b];
+            while (next[b] < end) {
+                uint32_t v = idx[next[b]];
+                int digit = keys[(size_t)v * stride + depth];
+                while (digit != b) {
+                    uint32_t displaced = idx[next[digit]];
+                    idx[next[digit]++] = v;
+                    v = displaced;
+                    digit = keys[(size_t)v * stride + depth];
+                }
+                idx[next[b]++] = v;
+            }
+        }
+
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            if (count[b] > 1) spec_radix_sort_range(keys, stride, idx + start[b], count[b], depth + 1, comparisons);
+        }
+        return;
+    }
+
+    // Small bucket: insertion sort on the rest of the key
+    for (int i = 1; i < n; i++) {
+        uint32_t v = idx[i];
+        const unsigned char* key = keys + (size_t)v * stride + depth;
+        int j = i - 1;
+        while (j >= 0) {
+            (*comparisons)++;
+            if (memcmp(keys + (size_t)idx[j] * stride + depth, key, stride - depth) <= 0) break;
+            idx[j + 1] = idx[j];
+            j--;
+        }
+        idx[j + 1] = v;
+    }
+}
+
+// Returns 0 (records untouched) if the key buffers cannot be allocated
+int spec_radix_sort(Student arr[], int n, const SortSpec* spec, long long* comparisons) {
+    if (n < 2) return 1;
+
+    size_t stride = spec->key_bytes;
+    unsigned char* keys = (unsigned char*)tracked_malloc(stride * (size_t)n);
+    uint32_t* idx = (uint32_t*)tracked_malloc(sizeof(uint32_t) * (size_t)n);
+    if (!keys || !idx) {
+        tracked_free(keys);
+        tracked_free(idx);
+        return 0;
+    }
+
+    for (int i = 0; i < n; i++) {
+        encode_spec_key(spec, &arr[i], (uint32_t)i, keys + stride * (size_t)i);
+        idx[i] = (uint32_t)i;
+    }
+    spec_radix_sort_range(keys, stride, idx, n, 0, comparisons);
+    apply_index_permutation(arr, idx, n);
+
+    tracked_free(keys);
+    tracked_free(idx);
+    return 1;
+}
+
+// Any comparator with a spec (all the standard ones and compare_active_spec); others, or a
+// failed allocation, fall back to merge_sort
+void radix_sort_spec(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    SortSpec spec;
+    if (!sort_spec_for(cmp, &spec) || !spec_radix_sort(arr, n, &spec, comparisons)) {
+        merge_sort(arr, n, cmp, comparisons);
+    }
+}
+
+
+// O. String Sort for NAME (Multikey Quicksort on Cached Prefixes)
+// compare_name_asc rescans every shared leading byte on each comparison. This sort keeps,
+// per record, the 8 name bytes at the current depth as a big-endian uint64_t (SortKey.key),
+// so one integer comparison checks 8 characters at once. A three-way partition on that
+// chunk splits a range into less / equal / greater; only the equal part moves on to the
+// next 8 bytes, so bytes below the depth are never looked at again. Small ranges use
+// insertion sort on the cached chunk, comparing further bytes only on a tie. Every chunk
+// comparison counts as one comparison; every byte loaded counts as a character inspection.
+// Descending order inverts the chunks. Other comparators fall back to merge_sort.
+#define NAME_CHUNK_BYTES 8
+#define MKQS_INSERTION_THRESHOLD 12
+
+// Big-endian bytes [depth, depth + 8) of name (zero after the terminator), XOR flip
+uint64_t load_name_chunk(const char* name, int depth, uint64_t flip) {
+    uint64_t chunk = 0;
+    int i = 0;
+    for (; i < NAME_CHUNK_BYTES && depth + i < MAX_NAME_LEN; i++) {
+        unsigned char c = (unsigned char)name[depth + i];
+        chunk = (chunk << 8) | c;
+        if (c == '\0') {
+            i++;
+            break;
+        }
+    }
+    char_inspections += i;
+    chunk <<= 8 * (NAME_CHUNK_BYTES - i);
+    return chunk ^ flip;
+}
+
+// 1 if the name ends inside this chunk (or reaches MAX_NAME_LEN): equal chunks mean equal names
+int name_chunk_is_last(uint64_t key, int depth, uint64_t flip) {
+    return ((key ^ flip) & 0xFF) == 0 || depth + NAME_CHUNK_BYTES >= MAX_NAME_LEN;
+}
+
+void reload_name_chunks(SortKey keys[], int n, const Student* base, int depth, uint64_t flip) {
+    for (int i = 0; i < n; i++) keys[i].key = load_name_chunk(base[keys[i].index].name, depth, flip);
+}
+
+// Orders two records whose chunks at depth are equal, from depth + 8 on
+int compare_name_tail(const Student* base, const SortKey* a, const SortKey* b, int depth, uint64_t flip, long long* comparisons) {
+    while (!name_chunk_is_last(a->key, depth, flip)) {
+        depth += NAME_CHUNK_BYTES;
+        uint64_t x = load_name_chunk(base[a->index].name, depth, flip);
+        uint64_t y = load_name_chunk(base[b->index].name, depth, flip);
+        (*comparisons)++;
+        if (x != y) return x < y ? -1 : 1;
+        if (name_chunk_is_last(x, depth, flip)) break;
+    }
+    return 0;
+}
+
+void name_insertion_sort(SortKey keys[], int n, const Student* base, int depth, uint64_t flip, long long* comparisons) {
+    for (int i = 1; i < n; i++) {
+        SortKey v = keys[i];
+        int j = i - 1;
+        while (j >= 0) {
+            (*comparisons)++;
+            if (keys[j].key < v.key) break;
+            if (keys[j].key == v.key && compare_name_tail(base, &keys[j], &v, depth, flip, comparisons) <= 0) break;
+            keys[j + 1] = keys[j];
+            j--;
+        }
+        keys[j + 1] = v;
+    }
+}
+
+#define SWAP_KEYS(a, b) do { SortKey t = a; a = b; b = t; } while (0)
+
+// keys[i].key holds the chunk at depth for every record of the range
+void multikey_quicksort(SortKey keys[], int n, const Student* base, int depth, uint64_t flip, long long* comparisons) {
+    while (n > MKQS_INSERTION_THRESHOLD) {
+        // Median-of-three pivot chunk
+        uint64_t a = keys[0].key, b = keys[n / 2].key, c = keys[n - 1].key;
+        *comparisons += 3;
+        uint64_t pivot = (a < b) ? ((b < c) ? b : (a < c) ? c : a) : ((a < c) ? a : (b < c) ? c : b);
+
+        // Dijkstra three-way partition: [0, lt) < pivot, [lt, i) == pivot, (gt, n) > pivot
+        int lt = 0, i = 0, gt = n - 1;
+        while (i <= gt) {
+            (*comparisons)++;
+            if (keys[i].key < pivot) {
+                SWAP_KEYS(keys[lt], keys[i]);
+                lt++;
+                i++;
+            }
+            else if (keys[i].key > pivot) {
+                SWAP_KEYS(keys[i], keys[gt]);
+                gt--;
+            }
+            else {
+                i++;
+            }
+        }
+
+        int less = lt;
+        int equal = gt + 1 - lt;
+        int greater = n - 1 - gt;
+        int equal_done = name_chunk_is_last(pivot, depth, flip); // Identical names: nothing left to order
+        if (!equal_done) reload_name_chunks(keys + lt, equal, base, depth + NAME_CHUNK_BYTES, flip);
+
+        // Recurse into the two smaller parts and loop on the largest, keeping the stack at O(log n) per depth
+        if (equal >= less && equal >= greater && !equal_done) {
+            multikey_quicksort(keys, less, base, depth, flip, comparisons);
+            multikey_quicksort(keys + gt + 1, greater, base, depth, flip, comparisons);
+            keys += lt;
+            n = equal;
+            depth += NAME_CHUNK_BYTES;
+        }
+        else {
+            if (!equal_done) multikey_quicksort(keys + lt, equal, base, depth + NAME_CHUNK_BYTES, flip, comparisons);
+            if (less < greater) {
+                multikey_quicksort(keys, less, base, depth, flip, comparisons);
+                keys += gt + 1;
+                n = greater;
+            }
+            else {
+                multikey_quicksort(keys + gt + 1, greater, base, depth, flip, comparisons);
+                n = less;
+            }
+        }
+    }
+    name_insertion_sort(keys, n, base, depth, flip, comparisons);
+}
+
+void name_string_sort(Student arr[], int n, CompareFunc cmp, long long* comparisons) {
+    if (n < 2) return;
+    if (cmp != compare_name_asc && cmp != compare_name_desc) {
+        merge_sort(arr, n, cmp, comparisons);
+        return;
+    }
+
+    SortKey* keys = (SortKey*)tracked_malloc(sizeof(SortKey) * n);
+    if (!keys) {
+        merge_sort(arr, n, cmp, comparisons);
+        return;
+    }
+
+    uint64_t flip = cmp == compare_name_desc ? UINT64_MAX : 0;
+    for (int i = 0; i < n; i++) {
+        keys[i].index = (uint32_t)i;
+        keys[i].key = load_name_chunk(arr[i].name, 0, flip);
+    }
+    multikey_quicksort(keys, n, arr, 0, flip, comparisons);
+    apply_permutation(arr, keys, n);
+    tracked_free(keys);
+}
+
+
+// P. B+-Tree Index (Incrementally Maintained Sorted View)
+// Keeps record indices in key order, so a record added to or removed from the roster costs
+// O(log n) comparisons instead of a full re-sort. Entries are uint32 indices into a Student
+// array (as in indirect mode), ordered by any CompareFunc with equal keys ordered by index:
+// every entry is distinct, a delete finds its record directly even among thousands of equal
+// GENDER keys, and the in-order walk matches a stable sort of the records in index order.
+//
+// Nodes are 256 bytes (four cache lines): a leaf holds 62 indices, an inner node 30
+// separators and 31 children. Separator keys[i] is always the smallest entry under
+// child[i + 1]. Nodes are carved from 64-byte-aligned arena blocks, addressed by 32-bit ids,
+// and released nodes are reused through a free list. A record's key fields must not change
+// while it is in the tree: delete it, update it, insert it again.
+#define BPT_NODE_BYTES 256
+#define BPT_LEAF_CAP ((BPT_NODE_BYTES - 8) / 4)       // 62 indices
+#define BPT_INNER_KEYS ((BPT_NODE_BYTES - 8 - 4) / 8) // 30 separators, 31 children
+#define BPT_LEAF_MIN (BPT_LEAF_CAP / 2)               // Below this a non-root node borrows or merges
+#define BPT_INNER_MIN (BPT_INNER_KEYS / 2)
+#define BPT_LEAF_FILL (BPT_LEAF_CAP * 7 / 8)          // Bulk load leaves room for later inserts
+#define BPT_INNER_FILL ((BPT_INNER_KEYS + 1) * 7 / 8)
+#define BPT_BLOCK_SHIFT 10                            // 1024 nodes (256 KB) per arena block
+#define BPT_BLOCK_NODES (1u << BPT_BLOCK_SHIFT)
+#define BPT_MAX_HEIGHT 32                             // 16^31 leaves is far beyond 2^32 entries
+#define BPT_BATCH_REBUILD_DIVISOR 16                  // Batches above size/16 are merged and bulk-loaded
+#define BPT_NIL UINT32_MAX
+
+typedef struct {
+    uint16_t count;  // Indices in a leaf, separator keys in an inner node
+    uint16_t leaf;
+    uint32_t next;   // Next leaf in key order; links the free list once released
+    union {
+        uint32_t items[BPT_LEAF_CAP];
+        struct {
+            uint32_t keys[BPT_INNER_KEYS];
+            uint32_t child[BPT_INNER_KEYS + 1];
+        } inner;
+    } u;
+} BPlusNode;
+
+typedef struct {
+    const Student* base;    // Records the indices refer to
+    CompareFunc cmp;
+    long long comparisons;  // Accumulated over the tree's lifetime
+    BPlusNode** blocks;     // Arena: node id = block << BPT_BLOCK_SHIFT | offset
+    int block_count;
+    int block_capacity;
+    uint32_t used_nodes;    // Ids handed out so far (released ones sit on free_list)
+    uint32_t free_list;
+    uint32_t root;          // BPT_NIL when empty
+    uint32_t first_leaf;
+    int height;             // 1 when the root is a leaf
+    int size;
+} BPlusTree;
+
+typedef struct {
+    const BPlusTree* tree;
+    uint32_t leaf;
+    int pos;
+} BPlusIterator;
+
+static inline BPlusNode* bptree_node(const BPlusTree* t, uint32_t id) {
+    return &t->blocks[id >> BPT_BLOCK_SHIFT][id & (BPT_BLOCK_NODES - 1)];
+}
+
+// Tree order: the comparator first, then the record index
+static inline int bptree_less(BPlusTree* t, uint32_t a, uint32_t b) {
+    int c = t->cmp(&t->base[a], &t->base[b], &t->comparisons);
+    return c < 0 || (c == 0 && a < b);
+}
+
+void bptree_init(BPlusTree* t, const Student* base, CompareFunc cmp) {
+    memset(t, 0, sizeof(BPlusTree));
+    t->base = base;
+    t->cmp = cmp;
+    t->free_list = BPT_NIL;
+    t->root = BPT_NIL;
+    t->first_leaf = BPT_NIL;
+}
+
+// Drops every entry; the arena blocks stay allocated for reuse
+void bptree_clear(BPlusTree* t) {
+    t->used_nodes = 0;
+    t->free_list = BPT_NIL;
+    t->root = BPT_NIL;
+    t->first_leaf = BPT_NIL;
+    t->height = 0;
+    t->size = 0;
+}
+
+void bptree_free(BPlusTree* t) {
+    for (int b = 0; b < t->block_count; b++) tracked_aligned_free(t->blocks[b]);
+    tracked_free(t->blocks);
+    t->blocks = NULL;
+    t->block_count = t->block_capacity = 0;
+    bptree_clear(t);
+}
+
+// Points the tree at a moved record array (e.g. after the roster was grown with realloc)
+void bptree_rebase(BPlusTree* t, const Student* base) {
+    t->base = base;
+}
+
+// Returns a node id, or BPT_NIL if the arena cannot grow
+uint32_t bptree_alloc_node(BPlusTree* t, int leaf) {
+    uint32_t id = t->free_list;
+    if (id != BPT_NIL) {
+        t->free_list = bptree_node(t, id)->next;
+    }
+    else {
+        if ((t->used_nodes >> BPT_BLOCK_SHIFT) >= (uint32_t)t->block_count) {
+            if (t->block_count == t->block_capacity) {
+                int capacity = t->block_capacity > 0 ? t->block_capacity * 2 : 8;
+                BPlusNode** blocks = (BPlusNode**)tracked_realloc(t->blocks, sizeof(BPlusNode*) * capacity);
+                if (!blocks) return BPT_NIL;
+                t->blocks = blocks;
+                t->block_capacity = capacity;
+            }
+            BPlusNode* block = (BPlusNode*)tracked_aligned_alloc(sizeof(BPlusNode) * BPT_BLOCK_NODES);
+            if (!block) return BPT_NIL;
+            t->blocks[t->block_count++] = block;
+        }
+        id = t->used_nodes++;
+    }
+
+    BPlusNode* node = bptree_node(t, id);
+    node->count = 0;
+    node->leaf = (uint16_t)leaf;
+    node->next = BPT_NIL;
+    return id;
+}
+
+void bptree_release_node(BPlusTree* t, uint32_t id) {
+    bptree_node(t, id)->next = t->free_list;
+    t->free_list = id;
+}
+
+// Position of the first entry of a[0, count) that is not less than x
+int bptree_lower_bound(BPlusTree* t, const uint32_t a[], int count, uint32_t x) {
+    int lo = 0, hi = count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (bptree_less(t, a[mid], x)) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Child of an inner node that holds (or would hold) x: separators equal to x go right
+int bptree_child_slot(BPlusTree* t, const BPlusNode* node, uint32_t x) {
+    int pos = bptree_lower_bound(t, node->u.inner.keys, node->count, x);
+    if (pos < node->count && node->u.inner.keys[pos] == x) pos++;
+    return pos;
+}
+
+// Walks from the root to the leaf for x, recording the nodes and child slots taken
+int bptree_descend(BPlusTree* t, uint32_t x, uint32_t path[], int slots[]) {
+    uint32_t id = t->root;
+    int level = 0;
+    while (!bptree_node(t, id)->leaf) {
+        int slot = bptree_child_slot(t, bptree_node(t, id), x);
+        path[level] = id;
+        slots[level++] = slot;
+        id = bptree_node(t, id)->u.inner.child[slot];
+    }
+    path[level] = id;
+    return level; // Depth of the leaf
+}
+
+// Builds the tree from indices already in tree order (a stable sort of increasing indices
+// qualifies). Leaves are filled to about 7/8 and the nodes of each level get even shares.
+// Returns 0 if memory runs out, leaving the tree empty.
+int bptree_bulk_load(BPlusTree* t, const uint32_t idx[], int n) {
+    bptree_clear(t);
+    if (n <= 0) return 1;
+
+    int count = (n + BPT_LEAF_FILL - 1) / BPT_LEAF_FILL;
+    uint32_t* ids = (uint32_t*)tracked_malloc(sizeof(uint32_t) * count * 2);
+    if (!ids) return 0;
+    uint32_t* mins = ids + count; // Smallest entry under each node of the current level
+
+    uint32_t prev = BPT_NIL;
+    for (int i = 0, start = 0; i < count; i++) {
+        int take = n / count + (i < n % count ? 1 : 0);
+        uint32_t id = bptree_alloc_node(t, 1);
+        if (id == BPT_NIL) {
+            tracked_free(ids);
+            bptree_clear(t);
+            return 0;
+        }
+        BPlusNode* leaf = bptree_node(t, id);
+        memcpy(leaf->u.items, idx + start, sizeof(uint32_t) * take);
+        leaf->count = (uint16_t)take;
+        if (prev == BPT_NIL) t->first_leaf = id;
+        else bptree_node(t, prev)->next = id;
+        prev = id;
+        ids[i] = id;
+        mins[i] = idx[start];
+        start += take;
+    }
+    t->height = 1;
+
+    while (count > 1) {
+        int parents = (count + BPT_INNER_FILL - 1) / BPT_INNER_FILL;
+        for (int p = 0, start = 0; p < parents; p++) {
+            int take = count / parents + (p < count % parents ? 1 : 0);
+            uint32_t id = bptree_alloc_node(t, 0);
+            if (id == BPT_NIL) {
+                tracked_free(ids);
+                bptree_clear(t);
+                return 0;
+            }
+            BPlusNode* node = bptree_node(t, id);
+            for (int c = 0; c < take; c++) {
+                node->u.inner.child[c] = ids[start + c];
+                if (c > 0) node->u.inner.keys[c - 1] = mins[start + c];
+            }
+            node->count = (uint16_t)(take - 1);
+            ids[p] = id; // p <= start, so the level is rewritten in place
+            mins[p] = mins[start];
+            start += take;
+        }
+        count = parents;
+        t->height++;
+    }
+
+    t->root = ids[0];
+    t->size = n;
+    tracked_free(ids);
+    return 1;
+}
+
+// Inserts record index x. Returns 1 on success, 0 if x is already present or memory runs out.
+int bptree_insert(BPlusTree* t, uint32_t x) {
+    if (t->root == BPT_NIL) {
+        uint32_t id = bptree_alloc_node(t, 1);
+        if (id == BPT_NIL) return 0;
+        BPlusNode* leaf = bptree_node(t, id);
+        leaf->u.items[0] = x;
+        leaf->count = 1;
+        t->root = t->first_leaf = id;
+        t->height = 1;
+        t->size = 1;
+        return 1;
+    }
+
+    uint32_t path[BPT_MAX_HEIGHT];
+    int slots[BPT_MAX_HEIGHT];
+    int level = bptree_descend(t, x, path, slots);
+    BPlusNode* leaf = bptree_node(t, path[level]);
+    int pos = bptree_lower_bound(t, leaf->u.items, leaf->count, x);
+    if (pos < leaf->count && leaf->u.items[pos] == x) return 0;
+
+    if (leaf->count < BPT_LEAF_CAP) {
+        memmove(leaf->u.items + pos + 1, leaf->u.items + pos, sizeof(uint32_t) * (leaf->count - pos));
+        leaf->u.items[pos] = x;
+        leaf->count++;
+        t->size++;
+        return 1;
+    }
+
+    // Split the full leaf: the new right half starts with the separator pushed upward.
+    // Every node the split cascade may need is reserved first, so a failure changes nothing.
+    uint32_t spare[BPT_MAX_HEIGHT + 1];
+    int needed = 1;
+    while (needed <= level && bptree_node(t, path[level - needed])->count == BPT_INNER_KEYS) needed++;
+    if (needed > level) needed++; // The root splits too: one more node for the new root
+    for (int i = 0; i < needed; i++) {
+        spare[i] = bptree_alloc_node(t, 0);
+        if (spare[i] == BPT_NIL) {
+            while (i-- > 0) bptree_release_node(t, spare[i]);
+            return 0;
+        }
+    }
+    int spare_used = 0;
+
+    uint32_t items[BPT_LEAF_CAP + 1];
+    memcpy(items, leaf->u.items, sizeof(uint32_t) * pos);
+    items[pos] = x;
+    memcpy(items + pos + 1, leaf->u.items + pos, sizeof(uint32_t) * (BPT_LEAF_CAP - pos));
+
+    uint32_t right_id = spare[spare_used++];
+    BPlusNode* right = bptree_node(t, right_id);
+    int left_count = (BPT_LEAF_CAP + 1) / 2;
+    right->leaf = 1;
+    right->count = (uint16_t)(BPT_LEAF_CAP + 1 - left_count);
+    memcpy(right->u.items, items + left_count, sizeof(uint32_t) * right->count);
+    leaf->count = (uint16_t)left_count;
+    memcpy(leaf->u.items, items, sizeof(uint32_t) * left_count);
+    right->next = leaf->next;
+    leaf->next = right_id;
+    t->size++;
+
+    uint32_t separator = right->u.items[0];
+    uint32_t new_child = right_id;
+    uint32_t left_id = path[level];
+
+    while (level > 0) {
+        level--;
+        BPlusNode* node = bptree_node(t, path[level]);
+        int slot = slots[level];
+        if (node->count < BPT_INNER_KEYS) {
+            memmove(node->u.inner.keys + slot + 1, node->u.inner.keys + slot, sizeof(uint32_t) * (node->count - slot));
+            memmove(node->u.inner.child + slot + 2, node->u.inner.child + slot + 1, sizeof(uint32_t) * (node->count - slot));
+            node->u.inner.keys[slot] = separator;
+            node->u.inner.child[slot + 1] = new_child;
+            node->count++;
+            while (spare_used < needed) bptree_release_node(t, spare[spare_used++]);
+            return 1;
+        }
+
+        // Full inner node: split around the middle separator, which moves up
+        uint32_t keys[BPT_INNER_KEYS + 1];
+        uint32_t child[BPT_INNER_KEYS + 2];
+        memcpy(keys, node->u.inner.keys, sizeof(uint32_t) * slot);
+        keys[slot] = separator;
+        memcpy(keys + slot + 1, node->u.inner.keys + slot, sizeof(uint32_t) * (BPT_INNER_KEYS - slot));
+        memcpy(child, node->u.inner.child, sizeof(uint32_t) * (slot + 1));
+        child[slot + 1] = new_child;
+        memcpy(child + slot + 2, node->u.inner.child + slot + 1, sizeof(uint32_t) * (BPT_INNER_KEYS - slot));
+
+        int mid = (BPT_INNER_KEYS + 1) / 2;
+        uint32_t sibling_id = spare[spare_used++];
+        BPlusNode* sibling = bptree_node(t, sibling_id);
+        sibling->leaf = 0;
+        sibling->count = (uint16_t)(BPT_INNER_KEYS - mid);
+        memcpy(sibling->u.inner.keys, keys + mid + 1, sizeof(uint32_t) * sibling->count);
+        memcpy(sibling->u.inner.child, child + mid + 1, sizeof(uint32_t) * (sibling->count + 1));
+        node->count = (uint16_t)mid;
+        memcpy(node->u.inner.keys, keys, sizeof(uint32_t) * mid);
+        memcpy(node->u.inner.child, child, sizeof(uint32_t) * (mid + 1));
+
+        separator = keys[mid];
+        new_child = sibling_id;
+        left_id = path[level];
+    }
+
+    // The root split: grow the tree by one level
+    uint32_t root_id = spare[spare_used++];
+    BPlusNode* root = bptree_node(t, root_id);
+    root->leaf = 0;
+    root->count = 1;
+    root->u.inner.keys[0] = separator;
+    root->u.inner.child[0] = left_id;
+    root->u.inner.child[1] = new_child;
+    t->root = root_id;
+    t->height++;
+    return 1;
+}
+
+// Refills the underfull child at slot of parent from a sibling, or merges the two.
+// Separators stay the smallest entries of their right subtrees.
+void bptree_fix_underflow(BPlusTree* t, BPlusNode* parent, int slot) {
+    int has_left = slot > 0;
+    uint32_t node_id = parent->u.inner.child[slot];
+    uint32_t sibling_id = parent->u.inner.child[has_left ? slot - 1 : slot + 1];
+    BPlusNode* node = bptree_node(t, node_id);
+    BPlusNode* sibling = bptree_node(t, sibling_id);
+    int min = node->leaf ? BPT_LEAF_MIN : BPT_INNER_MIN;
+
+    if (sibling->count > min) {
+        if (node->leaf) {
+            if (has_left) {
+                memmove(node->u.items + 1, node->u.items, sizeof(uint32_t) * node->count);
+                node->u.items[0] = sibling->u.items[--sibling->count];
+                parent->u.inner.keys[slot - 1] = node->u.items[0];
+            }
+            else {
+                node->u.items[node->count] = sibling->u.items[0];
+                memmove(sibling->u.items, sibling->u.items + 1, sizeof(uint32_t) * --sibling->count);
+                parent->u.inner.keys[slot] = sibling->u.items[0];
+            }
+        }
+        else if (has_left) {
+            // Rotate right: the parent separator comes down, the sibling's last key goes up
+            memmove(node->u.inner.keys + 1, node->u.inner.keys, sizeof(uint32_t) * node->count);
+            memmove(node->u.inner.child + 1, node->u.inner.child, sizeof(uint32_t) * (node->count + 1));
+            node->u.inner.keys[0] = parent->u.inner.keys[slot - 1];
+            node->u.inner.child[0] = sibling->u.inner.child[sibling->count];
+            parent->u.inner.keys[slot - 1] = sibling->u.inner.keys[sibling->count - 1];
+            sibling->count--;
+        }
+        else {
+            node->u.inner.keys[node->count] = parent->u.inner.keys[slot];
+            node->u.inner.child[node->count + 1] = sibling->u.inner.child[0];
+            parent->u.inner.keys[slot] = sibling->u.inner.keys[0];
+            sibling->count--;
+            memmove(sibling->u.inner.keys, sibling->u.inner.keys + 1, sizeof(uint32_t) * sibling->count);
+            memmove(sibling->u.inner.child, sibling->u.inner.child + 1, sizeof(uint32_t) * (sibling->count + 1));
+        }
+        node->count++;
+        return;
+    }
+
+    // Merge the right node of the pair into the left one and drop their separator
+    int left_slot = has_left ? slot - 1 : slot;
+    BPlusNode* left = has_left ? sibling : node;
+    BPlusNode* right = has_left ? node : sibling;
+    uint32_t right_id = has_left ? node_id : sibling_id;
+
+    if (left->leaf) {
+        memcpy(left->u.items + left->count, right->u.items, sizeof(uint32_t) * right->count);
+        left->count += right->count;
+        left->next = right->next;
+    }
+    else {
+        left->u.inner.keys[left->count] = parent->u.inner.keys[left_slot];
+        memcpy(left->u.inner.keys + left->count + 1, right->u.inner.keys, sizeof(uint32_t) * right->count);
+        memcpy(left->u.inner.child + left->count + 1, right->u.inner.child, sizeof(uint32_t) * (right->count + 1));
+        left->count += right->count + 1;
+    }
+    bptree_release_node(t, right_id);
+
+    parent->count--;
+    memmove(parent->u.inner.keys + left_slot, parent->u.inner.keys + left_slot + 1, sizeof(uint32_t) * (parent->count - left_slot));
+    memmove(parent->u.inner.child + left_slot + 1, parent->u.inner.child + left_slot + 2, sizeof(uint32_t) * (parent->count - left_slot));
+}
+
+// Removes record index x. Returns 1 if it was present.
+int bptree_delete(BPlusTree* t, uint32_t x) {
+    if (t->root == BPT_NIL) return 0;
+
+    uint32_t path[BPT_MAX_HEIGHT];
+    int slots[BPT_MAX_HEIGHT];
+    int level = bptree_descend(t, x, path, slots);
+    BPlusNode* leaf = bptree_node(t, path[level]);
+    int pos = bptree_lower_bound(t, leaf->u.items, leaf->count, x);
+    if (pos == leaf->count || leaf->u.items[pos] != x) return 0;
+
+    leaf->count--;
+    memmove(leaf->u.items + pos, leaf->u.items + pos + 1, sizeof(uint32_t) * (leaf->count - pos));
+    t->size--;
+
+    if (level == 0) {
+        if (leaf->count == 0) {
+            bptree_release_node(t, t->root);
+            bptree_clear(t);
+        }
+        return 1;
+    }
+
+    // x was the leaf's smallest entry, so it is the separator in the nearest ancestor
+    // where the path turned right
+    if (pos == 0 && leaf->count > 0) {
+        for (int l = level - 1; l >= 0; l--) {
+            if (slots[l] > 0) {
+                BPlusNode* node = bptree_node(t, path[l]);
+                if (node->u.inner.keys[slots[l] - 1] == x) node->u.inner.keys[slots[l] - 1] = leaf->u.items[0];
+                break;
+            }
+        }
+    }
+
+    // Rebalance upward while nodes are underfull
+    for (int l = level; l > 0; l--) {
+        BPlusNode* node = bptree_node(t, path[l]);
+        if (node->count >= (node->leaf ? BPT_LEAF_MIN : BPT_INNER_MIN)) break;
+        bptree_fix_underflow(t, bptree_node(t, path[l - 1]), slots[l - 1]);
+    }
+
+    // A root left with a single child is replaced by it
+    BPlusNode* root = bptree_node(t, t->root);
+    if (!root->leaf && root->count == 0) {
+        uint32_t old_root = t->root;
+        t->root = root->u.inner.child[0];
+        bptree_release_node(t, old_root);
+        t->height--;
+    }
+    return 1;
+}
+
+void bptree_begin(const BPlusTree* t, BPlusIterator* it) {
+    it->tree = t;
+    it->leaf = t->first_leaf;
+    it->pos = 0;
+}
+
+// Stores the next record index in tree order; returns 0 at the end
+int bptree_next(BPlusIterator* it, uint32_t* index) {
+    while (it->leaf != BPT_NIL) {
+        const BPlusNode* leaf = bptree_node(it->tree, it->leaf);
+        if (it->pos < leaf->count) {
+            *index = leaf->u.items[it->pos++];
+            return 1;
+        }
+        it->leaf = leaf->next;
+        it->pos = 0;
+    }
+    return 0;
+}
+
+// Writes all entries in tree order to out[0, size) and returns the count
+int bptree_to_array(const BPlusTree* t, uint32_t out[]) {
+    int count = 0;
+    for (uint32_t id = t->first_leaf; id != BPT_NIL;) {
+        const BPlusNode* leaf = bptree_node(t, id);
+        memcpy(out + count, leaf->u.items, sizeof(uint32_t) * leaf->count);
+        count += leaf->count;
+        id = leaf->next;
+    }
+    return count;
+}
+
+// Puts a batch into tree order with a bottom-up merge sort (temp holds n indices)
+void bptree_sort_batch(BPlusTree* t, uint32_t a[], int n, uint32_t temp[]) {
+    for (int width = 1; width < n; width *= 2) {
+        for (int lo = 0; lo < n; lo += 2 * width) {
+            int mid = lo + width < n ? lo + width : n;
+            int hi = lo + 2 * width < n ? lo + 2 * width : n;
+            int i = lo, j = mid, k = lo;
+            while (i < mid && j < hi) temp[k++] = bptree_less(t, a[j], a[i]) ? a[j++] : a[i++];
+            while (i < mid) temp[k++] = a[i++];
+            while (j < hi) temp[k++] = a[j++];
+        }
+        memcpy(a, temp, sizeof(uint32_t) * n);
+    }
+}
+
+// Applies a sorted batch to the tree by one merge with its in-order entries and a bulk
+// load: O(size + m log m) instead of m separate O(log size) updates with their node
+// splits or merges. remove selects deletion; entries already present (or absent, for a
+// deletion) are skipped; the batch is sorted and free of repeats. Returns the number of entries changed, or -1 if memory runs out.
+int bptree_rebuild_with_batch(BPlusTree* t, const uint32_t batch[], int m, int remove) {
+    uint32_t* merged = (uint32_t*)tracked_malloc(sizeof(uint32_t) * ((size_t)t->size * 2 + m + 1));
+    if (!merged) return -1;
+    uint32_t* current = merged + t->size + m;
+    int n = bptree_to_array(t, current);
+
+    int i = 0, j = 0, k = 0, changed = 0;
+    while (i < n || j < m) {
+        if (j == m || (i < n && batch[j] != current[i] && bptree_less(t, current[i], batch[j]))) {
+            merged[k++] = current[i++];
+        }
+        else if (i == n || batch[j] != current[i]) {
+            if (!remove) {
+                merged[k++] = batch[j];
+                changed++;
+            }
+            j++;
+        }
+        else {
+            if (remove) changed++; // Present: drop it, or keep the single copy
+            else merged[k++] = current[i];
+            i++;
+            j++;
+        }
+    }
+
+    int ok = bptree_bulk_load(t, merged, k);
+    tracked_free(merged);
+    return ok ? changed : -1;
+}
+
+// Inserts or deletes a batch of record indices. Small batches go through the single-entry
+// updates in key order; large ones rebuild the tree. Returns the number of entries changed,
+// or -1 if memory runs out.
+int bptree_apply_batch(BPlusTree* t, const uint32_t idx[], int m, int remove) {
+    if (m <= 0) return 0;
+    uint32_t* batch = (uint32_t*)tracked_malloc(sizeof(uint32_t) * m * 2);
+    if (!batch) return -1;
+    memcpy(batch, idx, sizeof(uint32_t) * m);
+    bptree_sort_batch(t, batch, m, batch + m);
+    int unique = 0;
+    for (int i = 0; i < m; i++) {
+        if (unique == 0 || batch[i] != batch[unique - 1]) batch[unique++] = batch[i];
+    }
+    m = unique;
+
+    int changed = 0;
+    if (m > t->size / BPT_BATCH_REBUILD_DIVISOR) {
+        changed = bptree_rebuild_with_batch(t, batch, m, remove);
+    }
+    else {
+        for (int i = 0; i < m; i++) {
+            if (remove) changed += bptree_delete(t, batch[i]);
+            else if (bptree_insert(t, batch[i])) changed++;
+        }
+    }
+    tracked_free(batch);
+    return changed;
+}
+
+int bptree_insert_batch(BPlusTree* t, const uint32_t idx[], int m) {
+    return bptree_apply_batch(t, idx, m, 0);
+}
+
+int bptree_delete_batch(BPlusTree* t, const uint32_t idx[], int m) {
+    return bptree_apply_batch(t, idx, m, 1);
+}
+
+// Index sort through the tree: the records arrive one at a time, as appended rows would,
+// and the in-order walk is the sorted index.
+void bptree_sort_indirect(const Student* base, uint32_t idx[], int n, CompareFunc cmp, long long* comparisons) {
+    BPlusTree tree;
+    bptree_init(&tree, base, cmp);
+    for (int i = 0; i < n; i++) {
+        if (!bptree_insert(&tree, idx[i])) {
+            fprintf(stderr, "Error: Memory allocation failed for B+-Tree Sort nodes.\n");
+            bptree_free(&tree);
+            return;
+        }
+    }
+    bptree_to_array(&tree, idx);
+    *comparisons += tree.comparisons;
+    bptree_free(&tree);
+}
+
+
+// --- Fast Data Loading (Memory-Mapped, Parallel Parsing) ---
+// load_students_mmap() maps the CSV instead of reading it line by line. The body is cut
+// into one byte range per thread at line boundaries; the threads first count their lines,
+// the Student array is allocated once for the total, and then each thread parses its lines
+// straight from the mapping into its own slice of the array. Fields are tokenized exactly
+// like the strtok(",\r\n") + atoi() loop in load_students(), without copying the line.
+// Platforms without mmap read the file into one buffer and use the same parser.
+
+#define LOADER_MIN_CHUNK_BYTES (1 << 20) // Smaller files are parsed by one thread
+
+typedef struct {
+    const char* data;
+    size_t size;
+    int is_mapped; // 1: munmap on release, 0: malloc'd copy
+} MappedFile;
+
+int map_file(const char* filename, MappedFile* mf) {
+    mf->data = NULL;
+    mf->size = 0;
+    mf->is_mapped = 0;
+
+#if HAVE_MMAP
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return 0;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return 0;
+    }
+    mf->size = (size_t)st.st_size;
+    if (mf->size == 0) {
+        close(fd);
+        return 1; // Nothing to map; callers see an empty file
+    }
+
+    void* addr = mmap(NULL, mf->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) return 0;
+    madvise(addr, mf->size, MADV_SEQUENTIAL);
+
+    mf->data = (const char*)addr;
+    mf->is_mapped = 1;
+    return 1;
+#else
+    FILE* fp = fopen(filename, "rb");
+    if (!fp) return 0;
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size < 0) {
+        fclose(fp);
+        return 0;
+    }
+
+    char* buffer = (char*)tracked_malloc((size_t)size + 1);
+    if (!buffer || fread(buffer, 1, (size_t)size, fp) != (size_t)size) {
+        tracked_free(buffer);
+        fclose(fp);
+        return 0;
+    }
+    fclose(fp);
+
+    mf->data = buffer;
+    mf->size = (size_t)size;
+    return 1;
+#endif
+}
+
+void unmap_file(MappedFile* mf) {
+#if HAVE_MMAP
+    if (mf->is_mapped) munmap((void*)mf->data, mf->size);
+    else tracked_free((void*)mf->data);
+#else
+    tracked_free((void*)mf->data);
+#endif
+    mf->data = NULL;
+    mf->size = 0;
+}
+
+// Next field of the line [*p, end), skipping empty fields like strtok does; NULL if none left
+const char* next_csv_token(const char** p, const char* end, const char** token_end) {
+    const char* s = *p;
+    while (s < end && (*s == ',' || *s == '\r')) s++;
+    if (s >= end) return NULL;
+
+    const char* e = s;
+    while (e < end && *e != ',' && *e != '\r') e++;
+    *token_end = e;
+    *p = e;
+    return s;
+}
+
+// atoi() over [s, end): optional whitespace and sign, then digits up to the first non-digit
+int parse_int_token(const char* s, const char* end) {
+    while (s < end && (*s == ' ' || *s == '\t')) s++;
+
+    int negative = 0;
+    if (s < end && (*s == '-' || *s == '+')) {
+        negative = (*s == '-');
+        s++;
+    }
+
+    int value = 0;
+    while (s < end && *s >= '0' && *s <= '9') {
+        value = value * 10 + (*s - '0');
+        s++;
+    }
+    return negative ? -value : value;
+}
+
+// Parses one line (without its '\n'); returns 0 if a field is missing, like load_students
+int parse_student_line(const char* line, const char* end, Student* s) {
+    const char* p = line;
+    const char* token_end = NULL;
+    const char* token;
+
+    memset(s, 0, sizeof(Student));
+
+    if (!(token = next_csv_token(&p, end, &token_end))) return 0;
+    s->id = parse_int_token(token, token_end);
+
+    if (!(token = next_csv_token(&p, end, &token_end))) return 0;
+    size_t len = (size_t)(token_end - token);
+    if (len > MAX_NAME_LEN - 1) len = MAX_NAME_LEN - 1;
+    memcpy(s->name, token, len);
+
+    if (!(token = next_csv_token(&p, end, &token_end))) return 0;
+    s->gender = token[0];
+
+    if (!(token = next_csv_token(&p, end, &token_end))) return 0;
+    s->korean = parse_int_token(token, token_end);
+
+    if (!(token = next_csv_token(&p, end, &token_end))) return 0;
+    s->english = parse_int_token(token, token_end);
+
+    if (!(token = next_csv_token(&p, end, &token_end))) return 0;
+    s->math = parse_int_token(token, token_end);
+
+    // Calculate total grade
+    s->total_grade = s->korean + s->english + s->math;
+    return 1;
+}
+
+typedef struct {
+    const char* begin; // Starts at a line start
+    const char* end;   // Ends after a '\n' (or at the end of the file)
+    int line_count;
+    int first_row;     // Where this chunk's rows start in the shared array
+    int parsed;        // Rows actually stored (lines with a missing field are skipped)
+    Student* arr;
+} ParseChunk;
+
+void* count_lines_task(void* arg) {
+    ParseChunk* chunk = (ParseChunk*)arg;
+    const char* p = chunk->begin;
+    int count = 0;
+
+    while (p < chunk->end) {
+        const char* nl = (const char*)memchr(p, '\n', (size_t)(chunk->end - p));
+        count++;
+        p = nl ? nl + 1 : chunk->end;
+    }
+    chunk->line_count = count;
+    return NULL;
+}
+
+void* parse_lines_task(void* arg) {
+    ParseChunk* chunk = (ParseChunk*)arg;
+    const char* p = chunk->begin;
+    Student* out = chunk->arr + chunk->first_row;
+    int parsed = 0;
+
+    while (p < chunk->end) {
+        const char* nl = (const char*)memchr(p, '\n', (size_t)(chunk->end - p));
+        const char* line_end = nl ? nl : chunk->end;
+        if (parse_student_line(p, line_end, &out[parsed])) parsed++;
+        p = nl ? nl + 1 : chunk->end;
+    }
+    chunk->parsed = parsed;
+    return NULL;
+}
+
+// Runs task on every chunk, one thread each (the calling thread takes chunk 0)
+void run_parse_tasks(void* (*task)(void*), ParseChunk chunks[], int count) {
+#if HAVE_PTHREADS
+    pthread_t threads[MAX_SORT_THREADS];
+    int started[MAX_SORT_THREADS] = { 0 };
+
+    for (int t = 1; t < count; t++) {
+        started[t] = pthread_create(&threads[t], NULL, task, &chunks[t]) == 0;
+        if (!started[t]) task(&chunks[t]);
+    }
+    task(&chunks[0]);
+    for (int t = 1; t < count; t++) {
+        if (started[t]) pthread_join(threads[t], NULL);
+    }
+#else
+    for (int t = 0; t < count; t++) task(&chunks[t]);
+#endif
+}
+
+Student* load_students_mmap(const char* filename, int* out_count) {
+    MappedFile mf;
+    *out_count = 0;
+    if (!map_file(filename, &mf)) {
+        perror("Failed to open file");
+        return NULL;
+    }
+
+    // Skip header line
+    const char* body = mf.size ? (const char*)memchr(mf.data, '\n', mf.size) : NULL;
+    if (!body) {
+        unmap_file(&mf);
+        return NULL;
+    }
+    body++;
+    const char* end = mf.data + mf.size;
+
+    // One chunk per thread, each extended to the next line start
+    int threads = resolve_thread_count();
+    size_t body_size = (size_t)(end - body);
+    if ((size_t)threads > body_size / LOADER_MIN_CHUNK_BYTES) threads = (int)(body_size / LOADER_MIN_CHUNK_BYTES);
+    if (threads < 1) threads = 1;
+
+    ParseChunk chunks[MAX_SORT_THREADS];
+    const char* p = body;
+    for (int t = 0; t < threads; t++) {
+        const char* chunk_end = (t == threads - 1) ? end : body + body_size * (t + 1) / threads;
+        if (chunk_end < p) chunk_end = p;
+        if (chunk_end < end) {
+            const char* nl = (const char*)memchr(chunk_end, '\n', (size_t)(end - chunk_end));
+            chunk_end = nl ? nl + 1 : end;
+        }
+        chunks[t].begin = p;
+        chunks[t].end = chunk_end;
+        chunks[t].line_count = 0;
+        chunks[t].parsed = 0;
+        p = chunk_end;
+    }
+
+    // Pass 1: count lines, so the array is allocated once with the exact size
+    run_parse_tasks(count_lines_task, chunks, threads);
+
+    int total_lines = 0;
+    for (int t = 0; t < threads; t++) {
+        chunks[t].first_row = total_lines;
+        total_lines += chunks[t].line_count;
+    }
+
+    Student* arr = (Student*)tracked_malloc(sizeof(Student) * (total_lines > 0 ? total_lines : 1));
+    if (!arr) {
+        perror("Memory allocation failed");
+        unmap_file(&mf);
+        return NULL;
+    }
+    for (int t = 0; t < threads; t++) chunks[t].arr = arr;
+
+    // Pass 2: parse every chunk into its slice
+    run_parse_tasks(parse_lines_task, chunks, threads);
+    unmap_file(&mf);
+
+    // Close the gaps left by skipped lines
+    int count = 0;
+    for (int t = 0; t < threads; t++) {
+        if (chunks[t].first_row != count) {
+            memmove(&arr[count], &arr[chunks[t].first_row], sizeof(Student) * chunks[t].parsed);
+        }
+        count += chunks[t].parsed;
+    }
+
+    *out_count = count;
+    return arr;
+}
+
+
+// --- Binary Column Cache ---
+// After the first CSV parse the dataset is written next to it as "<csv>.cache": a header
+// (row count, schema version, byte-order tag, the CSV's size and mtime, checksum) followed
+// by one fixed-width column per field. Later runs map the cache instead of parsing text.
+// The cache is ignored and rewritten when the CSV's size or mtime changed, the CSV is not
+// older than the cache (see source_unchanged), the schema or MAX_NAME_LEN differs, the
+// file is truncated, or the checksum does not match.
+
+#define CACHE_SUFFIX ".cache"
+#define CACHE_MAGIC "STUCACHE"
+#define CACHE_SCHEMA_VERSION 2
+#define CACHE_BYTE_ORDER_TAG 0x01020304u
+
+enum {
+    CACHE_COL_ID,
+    CACHE_COL_GENDER,
+    CACHE_COL_KOREAN,
+    CACHE_COL_ENGLISH,
+    CACHE_COL_MATH,
+    CACHE_COL_TOTAL,
+    CACHE_COL_NAME,
+    CACHE_COLUMN_COUNT
+};
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t name_len;   // MAX_NAME_LEN the cache was written with
+    uint32_t reserved;
+    uint64_t row_count;
+    uint64_t source_size;   // CSV size and modification time (see stat_source) when the cache was written
+    int64_t source_mtime;
+    uint64_t checksum;      // Over all column bytes, in column order
+    uint64_t column_offset[CACHE_COLUMN_COUNT]; // From the start of the file, 8-byte aligned
+} CacheHeader;
+
+size_t cache_column_width(int column) {
+    if (column == CACHE_COL_GENDER) return sizeof(char);
+    if (column == CACHE_COL_NAME) return MAX_NAME_LEN;
+    return sizeof(int32_t);
+}
+
+// FNV-1a over 64-bit words (a zero-padded tail word for the last bytes)
+uint64_t checksum_update(uint64_t hash, const void* data, size_t len) {
+    const unsigned char* p = (const unsigned char*)data;
+    while (len >= 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        hash = (hash ^ word) * 0x100000001b3ull;
+        p += 8;
+        len -= 8;
+    }
+    if (len > 0) {
+        uint64_t word = 0;
+        memcpy(&word, p, len);
+        hash = (hash ^ word) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+#define CHECKSUM_SEED 0xcbf29ce484222325ull
+
+// Size and modification time at the finest resolution available (nanoseconds, 100 ns
+// ticks on Windows); whole seconds would miss a same-size rewrite within a second
+int stat_source(const char* path, uint64_t* size, int64_t* mtime) {
+#if defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA attr;
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &attr)) return 0;
+    *size = ((uint64_t)attr.nFileSizeHigh << 32) | attr.nFileSizeLow;
+    *mtime = (int64_t)(((uint64_t)attr.ftLastWriteTime.dwHighDateTime << 32) | attr.ftLastWriteTime.dwLowDateTime);
+#else
+    struct stat st;
+    if (stat(path, &st) != 0) return 0;
+    *size = (uint64_t)st.st_size;
+#if defined(__APPLE__)
+    *mtime = (int64_t)st.st_mtimespec.tv_sec * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    *mtime = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+#endif
+    return 1;
+}
+
+// Whether source_path still has the size and mtime recorded in derived_path (a cache or
+// index) when it was written. Timestamps advance in clock ticks, so a same-size rewrite
+// in the tick the derived file was written keeps the old mtime; a source that is not
+// older than the derived file is therefore treated as changed, and the file is rebuilt.
+int source_unchanged(const char* source_path, const char* derived_path, uint64_t size, int64_t mtime) {
+    uint64_t source_size, derived_size;
+    int64_t source_mtime, derived_mtime;
+    if (!stat_source(source_path, &source_size, &source_mtime)) return 0;
+    if (!stat_source(derived_path, &derived_size, &derived_mtime)) return 0;
+    return source_size == size && source_mtime == mtime && source_mtime < derived_mtime;
+}
+
+void cache_path_for(const char* source_path, char* out, size_t out_size) {
+    snprintf(out, out_size, "%s%s", source_path, CACHE_SUFFIX);
+}
+
+// Copies field `column` of every record into buf (n values of cache_column_width(column))
+void extract_cache_column(const Student* arr, int n, int column, unsigned char* buf) {
+    for (int i = 0; i < n; i++) {
+        const Student* s = &arr[i];
+        int32_t v;
+        switch (column) {
+        case CACHE_COL_GENDER: buf[i] = (unsigned char)s->gender; continue;
+        case CACHE_COL_NAME: memcpy(buf + (size_t)i * MAX_NAME_LEN, s->name, MAX_NAME_LEN); continue;
+        case CACHE_COL_ID: v = s->id; break;
+        case CACHE_COL_KOREAN: v = s->korean; break;
+        case CACHE_COL_ENGLISH: v = s->english; break;
+        case CACHE_COL_MATH: v = s->math; break;
+        default: v = s->total_grade; break;
+        }
+        memcpy(buf + (size_t)i * sizeof(int32_t), &v, sizeof(int32_t));
+    }
+}
+
+int write_student_cache(const char* source_path, const Student* arr, int n) {
+    char cache_path[1024], temp_path[1040];
+    cache_path_for(source_path, cache_path, sizeof(cache_path));
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", cache_path);
+
+    CacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_SCHEMA_VERSION;
+    header.byte_order = CACHE_BYTE_ORDER_TAG;
+    header.name_len = MAX_NAME_LEN;
+    header.row_count = (uint64_t)n;
+    if (!stat_source(source_path, &header.source_size, &header.source_mtime)) return 0;
+
+    uint64_t offset = (sizeof(CacheHeader) + 7) & ~(uint64_t)7;
+    for (int c = 0; c < CACHE_COLUMN_COUNT; c++) {
+        header.column_offset[c] = offset;
+        offset = (offset + cache_column_width(c) * (uint64_t)n + 7) & ~(uint64_t)7;
+    }
+
+    unsigned char* column = (unsigned char*)tracked_malloc(MAX_NAME_LEN * (size_t)(n > 0 ? n : 1));
+    FILE* fp = column ? fopen(temp_path, "wb") : NULL;
+    if (!fp) {
+        tracked_free(column);
+        return 0;
+    }
+
+    // Header first with a zero checksum; it is rewritten once the columns are hashed
+    int ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    uint64_t written = sizeof(header);
+    uint64_t checksum = CHECKSUM_SEED;
+    static const unsigned char padding[8] = { 0 };
+
+    for (int c = 0; ok && c < CACHE_COLUMN_COUNT; c++) {
+        if (written < header.column_offset[c]) {
+            size_t pad = (size_t)(header.column_offset[c] - written);
+            ok = fwrite(padding, 1, pad, fp) == pad;
+            written += pad;
+        }
+
+        size_t bytes = cache_column_width(c) * (size_t)n;
+        extract_cache_column(arr, n, c, column);
+        checksum = checksum_update(checksum, column, bytes);
+        ok = ok && fwrite(column, 1, bytes, fp) == bytes;
+        written += bytes;
+    }
+
+    header.checksum = checksum;
+    ok = ok && fseek(fp, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, fp) == 1;
+    ok = (fclose(fp) == 0) && ok;
+    tracked_free(column);
+
+    // Publish the finished file under its real name (rename replaces an older cache)
+    if (!ok || rename(temp_path, cache_path) != 0) {
+        remove(temp_path);
+        return 0;
+    }
+    return 1;
+}
+
+// Maps the cache of source_path and validates it; on success mf stays mapped
+int map_student_cache(const char* source_path, MappedFile* mf, CacheHeader* header) {
+    char cache_path[1024];
+    cache_path_for(source_path, cache_path, sizeof(cache_path));
+
+    if (!map_file(cache_path, mf)) return 0;
+
+    int valid = mf->size >= sizeof(CacheHeader);
+    if (valid) {
+        memcpy(header, mf->data, sizeof(CacheHeader));
+        valid = memcmp(header->magic, CACHE_MAGIC, sizeof(header->magic)) == 0 &&
+            header->version == CACHE_SCHEMA_VERSION &&
+            header->byte_order == CACHE_BYTE_ORDER_TAG &&
+            header->name_len == MAX_NAME_LEN &&
+            source_unchanged(source_path, cache_path, header->source_size, header->source_mtime) &&
+            header->row_count <= (uint64_t)INT32_MAX;
+    }
+
+    // Every column must lie inside the file; the checksum covers all of them
+    uint64_t checksum = CHECKSUM_SEED;
+    for (int c = 0; valid && c < CACHE_COLUMN_COUNT; c++) {
+        uint64_t bytes = cache_column_width(c) * header->row_count;
+        valid = header->column_offset[c] <= mf->size && bytes <= mf->size - header->column_offset[c];
+        if (valid) checksum = checksum_update(checksum, mf->data + header->column_offset[c], (size_t)bytes);
+    }
+    valid = valid && checksum == header->checksum;
+
+    if (!valid) unmap_file(mf);
+    return valid;
+}
+
+// Returns the records from a valid, up-to-date cache, or NULL if it is missing or stale
+Student* load_student_cache(const char* source_path, int* out_count) {
+    MappedFile mf;
+    CacheHeader header;
+    if (!map_student_cache(source_path, &mf, &header)) return NULL;
+
+    int n = (int)header.row_count;
+    Student* arr = (Student*)tracked_malloc(sizeof(Student) * (n > 0 ? n : 1));
+
+    if (arr) {
+        const char* id = mf.data + header.column_offset[CACHE_COL_ID];
+        const char* gender = mf.data + header.column_offset[CACHE_COL_GENDER];
+        const char* korean = mf.data + header.column_offset[CACHE_COL_KOREAN];
+        const char* english = mf.data + header.column_offset[CACHE_COL_ENGLISH];
+        const char* math = mf.data + header.column_offset[CACHE_COL_MATH];
+        const char* total = mf.data + header.column_offset[CACHE_COL_TOTAL];
+        const char* name = mf.data + header.column_offset[CACHE_COL_NAME];
+
+        memset(arr, 0, sizeof(Student) * n);
+        for (int i = 0; i < n; i++) {
+            size_t off = (size_t)i * sizeof(int32_t);
+            memcpy(&arr[i].id, id + off, sizeof(int32_t));
+            arr[i].gender = gender[i];
+            memcpy(&arr[i].korean, korean + off, sizeof(int32_t));
+            memcpy(&arr[i].english, english + off, sizeof(int32_t));
+            memcpy(&arr[i].math, math + off, sizeof(int32_t));
+            memcpy(&arr[i].total_grade, total + off, sizeof(int32_t));
+            memcpy(arr[i].name, name + (size_t)i * MAX_NAME_LEN, MAX_NAME_LEN);
+        }
+        *out_count = n;
+    }
+
+    unmap_file(&mf);
+    return arr;
+}
+
+// Cache first; on a miss parse the CSV and (re)write the cache for the next run
+Student* load_students_cached(const char* filename, int* out_count, int* from_cache) {
+    *from_cache = 0;
+    Student* arr = load_student_cache(filename, out_count);
+    if (arr) {
+        *from_cache = 1;
+        return arr;
+    }
+
+    arr = load_students_mmap(filename, out_count);
+    if (arr && *out_count > 0 && !write_student_cache(filename, arr, *out_count)) {
+        fprintf(stderr, "Warning: Could not write binary cache for %s.\n", filename);
+    }
+    return arr;
+}
+
+
+// --- Persistent Key Indexes (Eytzinger Lookups) ---
+// For ID, NAME and TOTAL the sorted permutation of the dataset is computed once and saved
+// next to it as "<csv>.idx", so point and range queries (id = x, total in [a, b], name
+// prefix) become a binary search instead of a sort and a scan. Each key stores:
+//   perm       record indices in key order (stable: equal keys keep the input order)
+//   eytzinger  a 64-bit search key per record (packed ID or TOTAL, or the first 8 name
+//              bytes) laid out in BFS order of the implicit search tree: the children of
+//              slot k are 2k and 2k + 1, so the first levels share a few cache lines and the
+//              next ones can be prefetched
+//   rank       the sorted position of each Eytzinger slot, which turns a hit into an
+//              offset in perm
+// The whole index is one image (header, then 8-byte aligned sections) that is written as
+// is and mapped back; it is validated like the binary cache (source size and mtime,
+// schema, row count, checksum) and rebuilt when stale.
+
+#define INDEX_SUFFIX ".idx"
+#define INDEX_MAGIC "STUINDEX"
+#define INDEX_SCHEMA_VERSION 2
+
+typedef enum {
+    INDEX_KEY_ID,
+    INDEX_KEY_NAME,
+    INDEX_KEY_TOTAL,
+    INDEX_KEY_COUNT
+} IndexKey;
+
+static const char* const index_key_names[INDEX_KEY_COUNT] = { "id", "name", "total" };
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t name_len;
+    uint32_t key_count;
+    uint64_t row_count;
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t checksum;      // Over every byte after the header
+    uint64_t perm_offset[INDEX_KEY_COUNT];
+    uint64_t eytzinger_offset[INDEX_KEY_COUNT]; // n + 1 keys, slot 0 unused
+    uint64_t rank_offset[INDEX_KEY_COUNT];      // n + 1 positions, slot 0 unused
+} IndexHeader;
+
+typedef struct {
+    const uint32_t* perm;
+    const uint64_t* eytzinger;
+    const uint32_t* rank;
+} KeyIndex;
+
+typedef struct {
+    const char* image;   // Header followed by the sections
+    size_t size;
+    MappedFile mf;       // Backing file when the index was loaded
+    int is_loaded;       // 1: image lives in mf, 0: built in memory (malloc'd)
+    int n;
+    KeyIndex keys[INDEX_KEY_COUNT];
+} StudentIndex;
+
+#if defined(__GNUC__) || defined(__clang__)
+#define EYTZINGER_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define EYTZINGER_PREFETCH(p) ((void)0)
+#endif
+#define EYTZINGER_PREFETCH_LEVELS 4 // 2^4 keys of 8 bytes: slots 16k..16k+15 fill two cache lines
+
+// Search key of a record: compare as unsigned integers in the order of the key's comparator
+// (NAME only by its first 8 bytes; longer prefixes are narrowed with strncmp)
+uint64_t index_search_key(IndexKey key, const Student* s) {
+    if (key == INDEX_KEY_ID) return SIGNED_KEY(s->id);
+    if (key == INDEX_KEY_TOTAL) return SIGNED_KEY(s->total_grade);
+    return load_name_chunk(s->name, 0, 0);
+}
+
+CompareFunc index_key_compare(IndexKey key) {
+    if (key == INDEX_KEY_ID) return compare_id_asc;
+    if (key == INDEX_KEY_TOTAL) return compare_total_asc;
+    return compare_name_asc;
+}
+
+// Fills the subtree of slot k in order from sorted[next, ...); returns the next unused position
+size_t eytzinger_fill(const uint64_t sorted[], size_t n, uint64_t eyt[], uint32_t rank[], size_t next, size_t k) {
+    if (k > n) return next;
+    next = eytzinger_fill(sorted, n, eyt, rank, next, 2 * k);
+    eyt[k] = sorted[next];
+    rank[k] = (uint32_t)next;
+    return eytzinger_fill(sorted, n, eyt, rank, next + 1, 2 * k + 1);
+}
+
+// Sorted position of the first key >= x, or n. The loop body has no data-dependent branch:
+// the comparison result is added to the slot number, and the path is undone at the end.
+int eytzinger_lower_bound(const uint64_t eyt[], const uint32_t rank[], int n, uint64_t x) {
+    size_t k = 1;
+    size_t limit = (size_t)n;
+    while (k <= limit) {
+        size_t ahead = k << EYTZINGER_PREFETCH_LEVELS;
+        if (ahead <= limit) EYTZINGER_PREFETCH(eyt + ahead);
+        k = 2 * k + (eyt[k] < x);
+    }
+
+    // The trailing 1 bits of k are the right turns after the last left turn (the answer)
+#if defined(__GNUC__) || defined(__clang__)
+    k >>= __builtin_ctzll(~(unsigned long long)k) + 1;
+#else
+    while (k & 1) k >>= 1;
+    k >>= 1;
+#endif
+    return k == 0 ? n : (int)rank[k];
+}
+
+// Points the KeyIndex entries into the image
+void attach_student_index(StudentIndex* index, const IndexHeader* header) {
+    index->n = (int)header->row_count;
+    for (int key = 0; key < INDEX_KEY_COUNT; key++) {
+        index->keys[key].perm = (const uint32_t*)(index->image + header->perm_offset[key]);
+        index->keys[key].eytzinger = (const uint64_t*)(index->image + header->eytzinger_offset[key]);
+        index->keys[key].rank = (const uint32_t*)(index->image + header->rank_offset[key]);
+    }
+}
+
+// Sorts the permutation of every key and builds the image in memory. Returns 0 if memory runs out.
+int build_student_index(const char* source_path, const Student* arr, int n, StudentIndex* index) {
+    IndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = INDEX_SCHEMA_VERSION;
+    header.byte_order = CACHE_BYTE_ORDER_TAG;
+    header.name_len = MAX_NAME_LEN;
+    header.key_count = INDEX_KEY_COUNT;
+    header.row_count = (uint64_t)n;
+    if (source_path) stat_source(source_path, &header.source_size, &header.source_mtime);
+
+    uint64_t offset = (sizeof(IndexHeader) + 7) & ~(uint64_t)7;
+    for (int key = 0; key < INDEX_KEY_COUNT; key++) {
+        header.perm_offset[key] = offset;
+        offset = (offset + sizeof(uint32_t) * (uint64_t)n + 7) & ~(uint64_t)7;
+        header.eytzinger_offset[key] = offset;
+        offset += sizeof(uint64_t) * ((uint64_t)n + 1);
+        header.rank_offset[key] = offset;
+        offset = (offset + sizeof(uint32_t) * ((uint64_t)n + 1) + 7) & ~(uint64_t)7;
+    }
+
+    char* image = (char*)tracked_calloc(1, (size_t)offset);
+    uint64_t* sorted = (uint64_t*)tracked_malloc(sizeof(uint64_t) * (n > 0 ? n : 1));
+    if (!image || !sorted) {
+        tracked_free(image);
+        tracked_free(sorted);
+        return 0;
+    }
+
+    long long comparisons = 0;
+    for (int key = 0; key < INDEX_KEY_COUNT; key++) {
+        uint32_t* perm = (uint32_t*)(image + header.perm_offset[key]);
+        uint64_t* eyt = (uint64_t*)(image + header.eytzinger_offset[key]);
+        uint32_t* rank = (uint32_t*)(image + header.rank_offset[key]);
+
+        CompareFunc cmp = index_key_compare((IndexKey)key);
+        init_index(perm, n);
+        if (key_extractor_for(cmp)) key_sort_indirect(arr, perm, n, cmp, &comparisons);
+        else merge_sort_indirect(arr, perm, n, cmp, &comparisons);
+
+        for (int i = 0; i < n; i++) sorted[i] = index_search_key((IndexKey)key, &arr[perm[i]]);
+        eytzinger_fill(sorted, (size_t)n, eyt, rank, 0, 1);
+    }
+    tracked_free(sorted);
+
+    header.checksum = checksum_update(CHECKSUM_SEED, image + sizeof(IndexHeader), (size_t)offset - sizeof(IndexHeader));
+    memcpy(image, &header, sizeof(header));
+
+    memset(index, 0, sizeof(StudentIndex));
+    index->image = image;
+    index->size = (size_t)offset;
+    attach_student_index(index, &header);
+    return 1;
+}
+
+void index_path_for(const char* source_path, char* out, size_t out_size) {
+    snprintf(out, out_size, "%s%s", source_path, INDEX_SUFFIX);
+}
+
+int write_student_index(const char* source_path, const StudentIndex* index) {
+    char index_path[1024], temp_path[1040];
+    index_path_for(source_path, index_path, sizeof(index_path));
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", index_path);
+
+    FILE* fp = fopen(temp_path, "wb");
+    if (!fp) return 0;
+    int ok = fwrite(index->image, 1, index->size, fp) == index->size;
+    ok = (fclose(fp) == 0) && ok;
+
+    if (!ok || rename(temp_path, index_path) != 0) {
+        remove(temp_path);
+        return 0;
+    }
+    return 1;
+}
+
+// Maps the index of source_path if it is valid, up to date and covers n records
+int load_student_index(const char* source_path, int n, StudentIndex* index) {
+    char index_path[1024];
+    index_path_for(source_path, index_path, sizeof(index_path));
+
+    MappedFile mf;
+    if (!map_file(index_path, &mf)) return 0;
+
+    IndexHeader header;
+    int valid = mf.size >= sizeof(IndexHeader);
+    if (valid) {
+        memcpy(&header, mf.data, sizeof(IndexHeader));
+        valid = memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) == 0 &&
+            header.version == INDEX_SCHEMA_VERSION &&
+            header.byte_order == CACHE_BYTE_ORDER_TAG &&
+            header.name_len == MAX_NAME_LEN &&
+            header.key_count == INDEX_KEY_COUNT &&
+            header.row_count == (uint64_t)n &&
+            source_unchanged(source_path, index_path, header.source_size, header.source_mtime);
+    }
+
+    // Every section must lie inside the file, 8-byte aligned for the in-place arrays
+    for (int key = 0; valid && key < INDEX_KEY_COUNT; key++) {
+        uint64_t rank_end = header.rank_offset[key] + sizeof(uint32_t) * ((uint64_t)n + 1);
+        valid = header.perm_offset[key] % 8 == 0 && header.eytzinger_offset[key] % 8 == 0 &&
+            header.perm_offset[key] >= sizeof(IndexHeader) &&
+            header.perm_offset[key] + sizeof(uint32_t) * (uint64_t)n <= header.eytzinger_offset[key] &&
+            header.eytzinger_offset[key] + sizeof(uint64_t) * ((uint64_t)n + 1) <= header.rank_offset[key] &&
+            rank_end <= mf.size;
+    }
+    valid = valid && checksum_update(CHECKSUM_SEED, mf.data + sizeof(IndexHeader), mf.size - sizeof(IndexHeader)) == header.checksum;
+
+    if (!valid) {
+        unmap_file(&mf);
+        return 0;
+    }
+
+    memset(index, 0, sizeof(StudentIndex));
+    index->mf = mf;
+    index->is_loaded = 1;
+    index->image = mf.data;
+    index->size = mf.size;
+    attach_student_index(index, &header);
+    return 1;
+}
+
+void free_student_index(StudentIndex* index) {
+    if (index->is_loaded) unmap_file(&index->mf);
+    else tracked_free((void*)index->image);
+    memset(index, 0, sizeof(StudentIndex));
+}
+
+// Index file first; on a miss build the index and (re)write it for the next run.
+// source_path may be NULL for generated data, which is only indexed in memory.
+int open_student_index(const char* source_path, const Student* arr, int n, StudentIndex* index, int* from_file) {
+    *from_file = 0;
+    if (source_path && load_student_index(source_path, n, index)) {
+        *from_file = 1;
+        return 1;
+    }
+    if (!build_student_index(source_path, arr, n, index)) return 0;
+    if (source_path && !write_student_index(source_path, index)) {
+        fprintf(stderr, "Warning: Could not write key index for %s.\n", source_path);
+    }
+    return 1;
+}
+
+// Positions [*first, *first + count) of key's permutation whose search keys lie in [lo, hi]
+int index_key_range(const StudentIndex* index, IndexKey key, uint64_t lo, uint64_t hi, int* first) {
+    const KeyIndex* k = &index->keys[key];
+    int begin = eytzinger_lower_bound(k->eytzinger, k->rank, index->n, lo);
+    int end = hi == UINT64_MAX ? index->n : eytzinger_lower_bound(k->eytzinger, k->rank, index->n, hi + 1);
+    *first = begin;
+    return end > begin ? end - begin : 0;
+}
+
+// Records with lo <= ID <= hi (id = x is lo = hi = x), in ID order
+int index_find_id(const StudentIndex* index, int lo, int hi, int* first) {
+    *first = 0;
+    if (lo > hi) return 0;
+    return index_key_range(index, INDEX_KEY_ID, SIGNED_KEY(lo), SIGNED_KEY(hi), first);
+}
+
+// Records with lo <= TOTAL <= hi, in TOTAL ascending order
+int index_find_total(const StudentIndex* index, int lo, int hi, int* first) {
+    *first = 0;
+    if (lo > hi) return 0;
+    return index_key_range(index, INDEX_KEY_TOTAL, SIGNED_KEY(lo), SIGNED_KEY(hi), first);
+}
+
+// Records whose NAME starts with prefix, in NAME order; exact selects names equal to it.
+// The first 8 bytes are found through the Eytzinger keys, longer prefixes are narrowed
+// inside that range with two binary searches over the names themselves.
+int index_find_name(const StudentIndex* index, const Student* base, const char* prefix, int exact, int* first) {
+    size_t len = strlen(prefix) + (exact ? 1 : 0); // An exact match includes the terminator
+    if (len > MAX_NAME_LEN) len = MAX_NAME_LEN;
+
+    size_t head = len < NAME_CHUNK_BYTES ? len : NAME_CHUNK_BYTES;
+    uint64_t lo = 0;
+    for (size_t i = 0; i < NAME_CHUNK_BYTES; i++) lo = (lo << 8) | (i < head ? (unsigned char)prefix[i] : 0);
+    uint64_t hi = head == 0 ? UINT64_MAX : lo | (head == NAME_CHUNK_BYTES ? 0 : UINT64_MAX >> (8 * head));
+
+    int begin;
+    int count = index_key_range(index, INDEX_KEY_NAME, lo, hi, &begin);
+    if (len <= NAME_CHUNK_BYTES || count == 0) {
+        *first = begin;
+        return count;
+    }
+
+    const uint32_t* perm = index->keys[INDEX_KEY_NAME].perm;
+    int a = begin, b = begin + count;
+    while (a < b) { // First name >= prefix
+        int mid = a + (b - a) / 2;
+        if (strncmp(base[perm[mid]].name, prefix, len) < 0) a = mid + 1;
+        else b = mid;
+    }
+    int start = a;
+    b = begin + count;
+    while (a < b) { // First name > prefix
+        int mid = a + (b - a) / 2;
+        if (strncmp(base[perm[mid]].name, prefix, len) <= 0) a = mid + 1;
+        else b = mid;
+    }
+    *first = start;
+    return a - start;
+}
+
+// One lookup: "id=X", "id=A..B", "total=X", "total=A..B", "name=PREFIX*" or "name=EXACT"
+typedef struct {
+    IndexKey key;
+    int lo;
+    int hi;
+    int exact;              // NAME: whole name instead of a prefix
+    char name[MAX_NAME_LEN];
+} IndexQuery;
+
+// Parses an integer or an inclusive "A..B" range
+int parse_index_range(const char* text, int* lo, int* hi) {
+    char* end;
+    long a = strtol(text, &end, 10);
+    long b = a;
+    if (end == text) return 0;
+    if (strncmp(end, "..", 2) == 0) {
+        const char* second = end + 2;
+        b = strtol(second, &end, 10);
+        if (end == second) return 0;
+    }
+    if (*end != '\0' || a < INT_MIN || a > INT_MAX || b < INT_MIN || b > INT_MAX) return 0;
+    *lo = (int)a;
+    *hi = (int)b;
+    return 1;
+}
+
+int parse_index_query(const char* text, IndexQuery* q) {
+    memset(q, 0, sizeof(IndexQuery));
+    const char* eq = strchr(text, '=');
+    if (!eq) return 0;
+
+    size_t key_len = (size_t)(eq - text);
+    const char* value = eq + 1;
+    for (int key = 0; key < INDEX_KEY_COUNT; key++) {
+        if (strlen(index_key_names[key]) != key_len || strncmp(text, index_key_names[key], key_len) != 0) continue;
+        q->key = (IndexKey)key;
+        if (key != INDEX_KEY_NAME) return parse_index_range(value, &q->lo, &q->hi);
+
+        size_t len = strlen(value);
+        q->exact = len == 0 || value[len - 1] != '*';
+        if (!q->exact) len--;
+        if (len >= MAX_NAME_LEN) return 0;
+        memcpy(q->name, value, len);
+        q->name[len] = '\0';
+        return 1;
+    }
+    return 0;
+}
+
+// Runs q; returns the match count, the matches being [*first, *first + count) of the key's perm
+int run_index_query(const StudentIndex* index, const Student* base, const IndexQuery* q, int* first) {
+    if (q->key == INDEX_KEY_ID) return index_find_id(index, q->lo, q->hi, first);
+    if (q->key == INDEX_KEY_TOTAL) return index_find_total(index, q->lo, q->hi, first);
+    return index_find_name(index, base, q->name, q->exact, first);
+}
+
+
+// --- Struct-of-Arrays Storage ---
+// StudentColumns keeps each field in its own array and the names back to back in one
+// arena, so a pass over a single key reads 4 bytes per row (1 for gender) instead of
+// sizeof(Student). The column sorts order an index array like the indirect sorts do:
+// column_merge_sort() through the column comparators, and column_radix_sort() from packed
+// keys built by reading only the columns the criterion needs.
+
+typedef struct {
+    int n;
+    int* id;
+    char* gender;
+    int* korean;
+    int* english;
+    int* math;
+    int* total_grade;
+    uint32_t* name_offset; // Start of each NUL-terminated name in name_arena
+    char* name_arena;
+    size_t arena_size;
+} StudentColumns;
+
+void free_student_columns(StudentColumns* cols) {
+    tracked_free(cols->id);
+    tracked_free(cols->gender);
+    tracked_free(cols->korean);
+    tracked_free(cols->english);
+    tracked_free(cols->math);
+    tracked_free(cols->total_grade);
+    tracked_free(cols->name_offset);
+    tracked_free(cols->name_arena);
+    memset(cols, 0, sizeof(StudentColumns));
+}
+
+int allocate_student_columns(StudentColumns* cols, int n, size_t arena_size) {
+    size_t rows = (size_t)(n > 0 ? n : 1);
+    memset(cols, 0, sizeof(StudentColumns));
+    cols->n = n;
+    cols->id = (int*)tracked_malloc(sizeof(int) * rows);
+    cols->gender = (char*)tracked_malloc(rows);
+    cols->korean = (int*)tracked_malloc(sizeof(int) * rows);
+    cols->english = (int*)tracked_malloc(sizeof(int) * rows);
+    cols->math = (int*)tracked_malloc(sizeof(int) * rows);
+    cols->total_grade = (int*)tracked_malloc(sizeof(int) * rows);
+    cols->name_offset = (uint32_t*)tracked_malloc(sizeof(uint32_t) * rows);
+    cols->name_arena = (char*)tracked_malloc(arena_size > 0 ? arena_size : 1);
+    cols->arena_size = arena_size;
+
+    if (!cols->id || !cols->gender || !cols->korean || !cols->english || !cols->math ||
+        !cols->total_grade || !cols->name_offset || !cols->name_arena) {
+        free_student_columns(cols);
+        return 0;
+    }
+    return 1;
+}
+
+// Appends name (at most MAX_NAME_LEN bytes, NUL-terminated in the arena) for row i
+void store_column_name(StudentColumns* cols, int i, const char* name, size_t* arena_used) {
+    size_t len = strnlen(name, MAX_NAME_LEN - 1);
+    cols->name_offset[i] = (uint32_t)*arena_used;
+    memcpy(cols->name_arena + *arena_used, name, len);
+    cols->name_arena[*arena_used + len] = '\0';
+    *arena_used += len + 1;
+}
+
+int students_to_columns(const Student* arr, int n, StudentColumns* cols) {
+    size_t arena_size = 0;
+    for (int i = 0; i < n; i++) arena_size += strnlen(arr[i].name, MAX_NAME_LEN - 1) + 1;
+    if (arena_size > UINT32_MAX || !allocate_student_columns(cols, n, arena_size)) return 0;
+
+    size_t arena_used = 0;
+    for (int i = 0; i < n; i++) {
+        cols->id[i] = arr[i].id;
+        cols->gender[i] = arr[i].gender;
+        cols->korean[i] = arr[i].korean;
+        cols->english[i] = arr[i].english;
+        cols->math[i] = arr[i].math;
+        cols->total_grade[i] = arr[i].total_grade;
+        store_column_name(cols, i, arr[i].name, &arena_used);
+    }
+    return 1;
+}
+
+void column_row_to_student(const StudentColumns* cols, uint32_t i, Student* s) {
+    memset(s, 0, sizeof(Student));
+    s->id = cols->id[i];
+    strncpy(s->name, cols->name_arena + cols->name_offset[i], MAX_NAME_LEN - 1);
+    s->gender = cols->gender[i];
+    s->korean = cols->korean[i];
+    s->english = cols->english[i];
+    s->math = cols->math[i];
+    s->total_grade = cols->total_grade[i];
+}
+
+Student* columns_to_students(const StudentColumns* cols) {
+    Student* arr = (Student*)tracked_malloc(sizeof(Student) * (cols->n > 0 ? cols->n : 1));
+    if (!arr) return NULL;
+    for (int i = 0; i < cols->n; i++) column_row_to_student(cols, (uint32_t)i, &arr[i]);
+    return arr;
+}
+
+// Column counterpart of gather_students(): rows in idx order as Student records
+void gather_columns(const StudentColumns* cols, const uint32_t idx[], int n, Student out[]) {
+    for (int i = 0; i < n; i++) column_row_to_student(cols, idx[i], &out[i]);
+}
+
+// Columns straight from a valid binary cache (no AoS detour), else from the CSV
+int load_student_columns(const char* filename, StudentColumns* cols) {
+    MappedFile mf;
+    CacheHeader header;
+    if (map_student_cache(filename, &mf, &header)) {
+        int n = (int)header.row_count;
+        const char* names = mf.data + header.column_offset[CACHE_COL_NAME];
+
+        size_t arena_size = 0;
+        for (int i = 0; i < n; i++) arena_size += strnlen(names + (size_t)i * MAX_NAME_LEN, MAX_NAME_LEN - 1) + 1;
+
+        int ok = arena_size <= UINT32_MAX && allocate_student_columns(cols, n, arena_size);
+        if (ok) {
+            memcpy(cols->id, mf.data + header.column_offset[CACHE_COL_ID], sizeof(int) * n);
+            memcpy(cols->gender, mf.data + header.column_offset[CACHE_COL_GENDER], (size_t)n);
+            memcpy(cols->korean, mf.data + header.column_offset[CACHE_COL_KOREAN], sizeof(int) * n);
+            memcpy(cols->english, mf.data + header.column_offset[CACHE_COL_ENGLISH], sizeof(int) * n);
+            memcpy(cols->math, mf.data + header.column_offset[CACHE_COL_MATH], sizeof(int) * n);
+            memcpy(cols->total_grade, mf.data + header.column_offset[CACHE_COL_TOTAL], sizeof(int) * n);
+
+            size_t arena_used = 0;
+            for (int i = 0; i < n; i++) store_column_name(cols, i, names + (size_t)i * MAX_NAME_LEN, &arena_used);
+        }
+        unmap_file(&mf);
+        return ok;
+    }
+
+    int n = 0, from_cache = 0;
+    Student* arr = load_students_cached(filename, &n, &from_cache);
+    if (!arr) return 0;
+    int ok = students_to_columns(arr, n, cols);
+    tracked_free(arr);
+    return ok;
+}
+
+// Column comparators: same results and comparison counts as the Student comparators
+typedef int (*ColumnCompareFunc)(const StudentColumns*, uint32_t, uint32_t, long long*);
+
+int column_compare_grades(const StudentColumns* c, uint32_t a, uint32_t b, long long* comparisons) {
+    (*comparisons)++;
+    if (c->korean[a] != c->korean[b]) return c->korean[b] - c->korean[a];
+    (*comparisons)++;
+    if (c->english[a] != c->english[b]) return c->english[b] - c->english[a];
+    (*comparisons)++;
+    if (c->math[a] != c->math[b]) return c->math[b] - c->math[a];
+    return 0;
+}
+
+int column_compare_id_asc(const StudentColumns* c, uint32_t a, uint32_t b, long long* comparisons) {
+    (*comparisons)++;
+    return c->id[a] - c->id[b];
+}
+
+int column_compare_id_desc(const StudentColumns* c, uint32_t a, uint32_t b, long long* comparisons) {
+    (*comparisons)++;
+    return c->id[b] - c->id[a];
+}
+
+int column_compare_name_asc(const StudentColumns* c, uint32_t a, uint32_t b, long long* comparisons) {
+    (*comparisons)++;
+    return compare_name_bytes(c->name_arena + c->name_offset[a], c->name_arena + c->name_offset[b]);
+}
+
+int column_compare_name_desc(const StudentColumns* c, uint32_t a, uint32_t b, long long* comparisons) {
+    (*comparisons)++;
+    return compare_name_bytes(c->name_arena + c->name_offset[b], c->name_arena + c->name_offset[a]);
+}
+
+int column_compare_gender_asc(const StudentColumns* c, uint32_t a, uint32_t b, long long* comparisons) {
+    (*comparisons)++;
+    return c->gender[a] - c->gender[b];
+}
+
+int column_compare_gender_desc(const StudentColumns* c, uint32_t a, uint32_t b, long long* comparisons) {
+    (*comparisons)++;
+    return c->gender[b] - c->gender[a];
+}
+
+int column_compare_total_asc(const StudentColumns* c, uint32_t a, uint32_t b, long long* comparisons) {
+    (*comparisons)++;
+    if (c->total_grade[a] != c->total_grade[b]) return c->total_grade[a] - c->total_grade[b];
+    return column_compare_grades(c, a, b, comparisons);
+}
+
+int column_compare_total_desc(const StudentColumns* c, uint32_t a, uint32_t b, long long* comparisons) {
+    (*comparisons)++;
+    if (c->total_grade[a] != c->total_grade[b]) return c->total_grade[b] - c->total_grade[a];
+    return column_compare_grades(c, a, b, comparisons);
+}
+
+// spec_column_int() for row r of the columns
+int column_int(const StudentColumns* c, SortColumn column, uint32_t r) {
+    switch (column) {
+    case COLUMN_ID: return c->id[r];
+    case COLUMN_KOREAN: return c->korean[r];
+    case COLUMN_ENGLISH: return c->english[r];
+    case COLUMN_MATH: return c->math[r];
+    default: return c->total_grade[r];
+    }
+}
+
+// compare_by_spec() on the active --order spec, reading only the columns it names
+int column_compare_active_spec(const StudentColumns* c, uint32_t a, uint32_t b, long long* comparisons) {
+    for (int k = 0; k < active_sort_spec.count; k++) {
+        SortColumn column = active_sort_spec.keys[k].column;
+        int r;
+        (*comparisons)++;
+        if (column == COLUMN_NAME) {
+            r = compare_name_bytes(c->name_arena + c->name_offset[a], c->name_arena + c->name_offset[b]);
+        }
+        else if (column == COLUMN_GENDER) {
+            r = (int)spec_gender_byte(c->gender[a]) - (int)spec_gender_byte(c->gender[b]);
+        }
+        else {
+            int x = column_int(c, column, a);
+            int y = column_int(c, column, b);
+            r = (x > y) - (x < y);
+        }
+        if (r != 0) return active_sort_spec.keys[k].descending ? -r : r;
+    }
+    return 0;
+}
+
+ColumnCompareFunc column_compare_for(CompareFunc cmp) {
+    if (cmp == compare_id_asc) return column_compare_id_asc;
+    if (cmp == compare_id_desc) return column_compare_id_desc;
+    if (cmp == compare_name_asc) return column_compare_name_asc;
+    if (cmp == compare_name_desc) return column_compare_name_desc;
+    if (cmp == compare_gender_asc) return column_compare_gender_asc;
+    if (cmp == compare_gender_desc) return column_compare_gender_desc;
+    if (cmp == compare_total_asc) return column_compare_total_asc;
+    if (cmp == compare_total_desc) return column_compare_total_desc;
+    if (cmp == compare_active_spec) return column_compare_active_spec;
+    return NULL;
+}
+
+// Packed keys (same encoding as the Student extractors) for the rows in idx, reading only
+// the columns the criterion uses. Returns 0 for NAME or an out-of-range grade.
+int extract_column_keys(const StudentColumns* c, const uint32_t idx[], int n, CompareFunc cmp, SortKey keys[]) {
+    if (cmp == compare_id_asc || cmp == compare_id_desc) {
+        uint32_t flip = (cmp == compare_id_desc) ? 0xFFFFFFFFu : 0;
+        for (int i = 0; i < n; i++) {
+            keys[i].key = SIGNED_KEY(c->id[idx[i]]) ^ flip;
+            keys[i].index = idx[i];
+        }
+        return 1;
+    }
+    if (cmp == compare_gender_asc || cmp == compare_gender_desc) {
+        for (int i = 0; i < n; i++) {
+            int g = (int)c->gender[idx[i]] + 128;
+            keys[i].key = (uint64_t)(cmp == compare_gender_desc ? 383 - g : g);
+            keys[i].index = idx[i];
+        }
+        return 1;
+    }
+    if (cmp == compare_total_asc || cmp == compare_total_desc) {
+        for (int i = 0; i < n; i++) {
+            uint32_t r = idx[i];
+            int total = c->total_grade[r], kor = c->korean[r], eng = c->english[r], mat = c->math[r];
+            if (total < 0 || total > PACKED_FIELD_MAX || kor < 0 || kor > PACKED_FIELD_MAX ||
+                eng < 0 || eng > PACKED_FIELD_MAX || mat < 0 || mat > PACKED_FIELD_MAX) {
+                return 0;
+            }
+            uint64_t t = (cmp == compare_total_desc) ? (uint64_t)(PACKED_FIELD_MAX - total) : (uint64_t)total;
+            keys[i].key = (t << 48) |
+                ((uint64_t)(PACKED_FIELD_MAX - kor) << 32) |
+                ((uint64_t)(PACKED_FIELD_MAX - eng) << 16) |
+                (uint64_t)(PACKED_FIELD_MAX - mat);
+            keys[i].index = r;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+typedef void (*ColumnSortFunc)(const StudentColumns*, uint32_t[], int, CompareFunc, long long*);
+
+void column_merge(const StudentColumns* cols, uint32_t idx[], int l, int m, int r, ColumnCompareFunc ccmp, long long* comparisons, uint32_t temp_idx[]) {
+    int n1 = m - l + 1;
+    memcpy(temp_idx, &idx[l], sizeof(uint32_t) * n1);
+
+    int i = 0, j = m + 1, k = l;
+    while (i < n1 && j <= r) {
+        // Stable property: use <= 0
+        if (ccmp(cols, temp_idx[i], idx[j], comparisons) <= 0) idx[k++] = temp_idx[i++];
+        else idx[k++] = idx[j++];
+    }
+    while (i < n1) idx[k++] = temp_idx[i++];
+}
+
+void column_merge_sort_recursive(const StudentColumns* cols, uint32_t idx[], int l, int r, ColumnCompareFunc ccmp, long long* comparisons, uint32_t temp_idx[]) {
+    if (l < r) {
+        int m = l + (r - l) / 2;
+        column_merge_sort_recursive(cols, idx, l, m, ccmp, comparisons, temp_idx);
+        column_merge_sort_recursive(cols, idx, m + 1, r, ccmp, comparisons, temp_idx);
+        column_merge(cols, idx, l, m, r, ccmp, comparisons, temp_idx);
+    }
+}
+
+void column_merge_sort(const StudentColumns* cols, uint32_t idx[], int n, CompareFunc cmp, long long* comparisons) {
+    ColumnCompareFunc ccmp = column_compare_for(cmp);
+    uint32_t* temp_idx = (uint32_t*)tracked_malloc(sizeof(uint32_t) * (n / 2 + 1));
+    if (!ccmp || !temp_idx) {
+        fprintf(stderr, "Error: Column Merge Sort needs a known comparator and an auxiliary index array.\n");
+        tracked_free(temp_idx);
+        return;
+    }
+    column_merge_sort_recursive(cols, idx, 0, n - 1, ccmp, comparisons, temp_idx);
+    tracked_free(temp_idx);
+}
+
+void column_radix_sort(const StudentColumns* cols, uint32_t idx[], int n, CompareFunc cmp, long long* comparisons) {
+    if (n < 2) return;
+
+    SortKey* keys = (SortKey*)tracked_malloc(sizeof(SortKey) * n * 2);
+    if (!keys || !extract_column_keys(cols, idx, n, cmp, keys)) {
+        tracked_free(keys);
+        column_merge_sort(cols, idx, n, cmp, comparisons);
+        return;
+    }
+
+    SortKey* sorted = radix_sort_pairs(keys, keys + n, n);
+    if (sorted) {
+        for (int i = 0; i < n; i++) idx[i] = sorted[i].index;
+    }
+    tracked_free(keys);
+}
+
+
+// --- Main Testing and Averaging Logic ---
+
+// --- Timing and Hardware Counters ---
+// Each repetition measures only the sort call (and the gather in indirect mode), not the
+// copy of the input. Hardware counters come from perf_event_open on Linux and are
+// reported as N/A when the kernel or the CPU does not allow them (containers, VMs, Windows).
+
+const char* hw_counter_names[HW_COUNTER_COUNT] = { "Cycles", "Instructions", "Branch Misses", "LLC Misses" };
+
+typedef struct {
+    int fd[HW_COUNTER_COUNT]; // -1 if the counter could not be opened
+} HwCounters;
+
+typedef struct {
+    uint64_t start_ns;
+    uint64_t elapsed_ns;
+    long long hw[HW_COUNTER_COUNT]; // -1 if the counter is unavailable
+    size_t stack_bytes; // Stack high-water mark of the measured call
+} Measurement;
+
+uint64_t now_ns(void) {
+    struct timespec ts;
+#if defined(_WIN32)
+    timespec_get(&ts, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void hw_counters_open(HwCounters* hw) {
+    for (int c = 0; c < HW_COUNTER_COUNT; c++) hw->fd[c] = -1;
+
+#if HAVE_PERF_EVENTS
+    const uint64_t configs[HW_COUNTER_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_MISSES, // Last-level cache misses on most CPUs
+    };
+
+    for (int c = 0; c < HW_COUNTER_COUNT; c++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[c];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        // Counts the calling thread on whichever CPU it runs
+        hw->fd[c] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+}
+
+void hw_counters_close(HwCounters* hw) {
+#if HAVE_PERF_EVENTS
+    for (int c = 0; c < HW_COUNTER_COUNT; c++) {
+        if (hw->fd[c] >= 0) close(hw->fd[c]);
+    }
+#endif
+    for (int c = 0; c < HW_COUNTER_COUNT; c++) hw->fd[c] = -1;
+}
+
+void measurement_start(Measurement* m, const HwCounters* hw) {
+#if HAVE_PERF_EVENTS
+    for (int c = 0; c < HW_COUNTER_COUNT; c++) {
+        if (hw->fd[c] < 0) continue;
+        ioctl(hw->fd[c], PERF_EVENT_IOC_RESET, 0);
+        ioctl(hw->fd[c], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#else
+    (void)hw;
+#endif
+    m->start_ns = now_ns();
+}
+
+void measurement_stop(Measurement* m, const HwCounters* hw) {
+    m->elapsed_ns = now_ns() - m->start_ns;
+
+    for (int c = 0; c < HW_COUNTER_COUNT; c++) {
+        m->hw[c] = -1;
+#if HAVE_PERF_EVENTS
+        if (hw->fd[c] < 0) continue;
+        ioctl(hw->fd[c], PERF_EVENT_IOC_DISABLE, 0);
+        long long value = 0;
+        if (read(hw->fd[c], &value, sizeof(value)) == (ssize_t)sizeof(value)) {
+            m->hw[c] = value;
+        }
+#else
+        (void)hw;
+#endif
+    }
+}
+
+int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Fills min/median/p99 from the per-repetition times (sorts the array in place)
+void summarize_times(uint64_t times[], int count, SortMetrics* metrics) {
+    if (count <= 0) return;
+
+    qsort(times, count, sizeof(uint64_t), compare_u64);
+    metrics->time_min_ns = (double)times[0];
+    metrics->time_median_ns = (count % 2) ? (double)times[count / 2]
+        : ((double)times[count / 2 - 1] + (double)times[count / 2]) / 2.0;
+
+    int p99_rank = (int)ceil(0.99 * count) - 1; // Nearest-rank percentile
+    metrics->time_p99_ns = (double)times[p99_rank < 0 ? 0 : p99_rank];
+}
+
+
+// Structure to define a single sort test case
+typedef struct {
+    char name[50];
+    void (*sort_func)(Student[], int, CompareFunc, long long*);
+    CompareFunc cmp_func;
+    char cmp_name[50];
+    int skip_heap_tree; // 1 if key has duplicates (skip Heap/Tree), 0 otherwise
+    int is_radix; // 1 if Radix sort
+    IndexSortFunc index_sort_func; // Non-NULL: sort an index array over the shared dataset instead
+    int gather; // Indirect mode only: 1 to build the sorted Student array from the index afterwards
+    ColumnSortFunc column_sort_func; // Non-NULL: indirect mode over the dataset's StudentColumns
+} SortTest;
+
+int is_indirect_test(const SortTest* test) {
+    return test->index_sort_func != NULL || test->column_sort_func != NULL;
+}
+
+// The only key a sort that ignores its comparator produces, or NULL if it honours cmp
+CompareFunc fixed_sort_key(const SortTest* test) {
+    if (test->sort_func == radix_sort_id || test->index_sort_func == radix_sort_id_indirect) return compare_id_asc;
+    return NULL;
+}
+
+// Top-k and nth-element rows place only part of the input; the rest is left unordered
+int is_partial_sort(const SortTest* test) {
+    return test->sort_func == top_k || test->sort_func == top_k_introselect || test->sort_func == nth_element_median;
+}
+
+// --- Repetition Workers ---
+// Repetitions are independent, so run_test hands them to a pool of workers: worker w runs
+// repetitions w, w + W, w + 2W, ... Each worker allocates its sort buffers once and reuses
+// them, opens its own hardware counters, and keeps its own totals; run_test merges them at
+// the end. With one worker everything runs on the calling thread.
+
+typedef struct {
+    const Student* original_data;
+    const StudentColumns* columns; // Column mode only, built once by run_test
+    int n;
+    SortTest test;
+    int worker_id;
+    int worker_count;
+    uint64_t* times; // Shared, indexed by repetition; each worker writes only its own slots
+
+    // Reusable buffers
+    Student* arr;     // Direct mode: copy of the input sorted in place
+    uint32_t* idx;    // Indirect mode: index array
+    Student* sorted;  // Indirect mode with gather: sorted records
+
+    // Per-worker accumulators
+    long long comparisons;
+    long long char_inspections;
+    size_t buffer_bytes;    // Footprint of the reusable buffers
+    size_t peak_heap_bytes; // Largest heap growth during one repetition
+    size_t stack_bytes;
+    long long allocations;
+    long long hw_totals[HW_COUNTER_COUNT]; // -1 once a counter fails
+    int completed;
+    int failed;
+} RepetitionWorker;
+
+int allocate_worker_buffers(RepetitionWorker* w) {
+    if (!is_indirect_test(&w->test)) {
+        w->arr = (Student*)tracked_malloc(sizeof(Student) * w->n);
+        return w->arr != NULL;
+    }
+    w->idx = (uint32_t*)tracked_malloc(sizeof(uint32_t) * w->n);
+    if (w->test.gather) w->sorted = (Student*)tracked_malloc(sizeof(Student) * w->n);
+    return w->idx != NULL && (!w->test.gather || w->sorted != NULL);
+}
+
+void free_worker_buffers(RepetitionWorker* w) {
+    tracked_free(w->arr);
+    tracked_free(w->idx);
+    tracked_free(w->sorted);
+    w->arr = NULL;
+    w->idx = NULL;
+    w->sorted = NULL;
+}
+
+// One repetition: reset the input, then measure only the sort (and the gather in indirect mode)
+void run_repetition(RepetitionWorker* w, long long* comparisons, Measurement* m, const HwCounters* hw) {
+    SortTest* test = &w->test;
+
+    if (!is_indirect_test(test)) {
+        memcpy(w->arr, w->original_data, sizeof(Student) * w->n);
+
+        paint_stack();
+        measurement_start(m, hw);
+        test->sort_func(w->arr, w->n, test->cmp_func, comparisons);
+        measurement_stop(m, hw);
+        m->stack_bytes = stack_high_water();
+        return;
+    }
+
+    init_index(w->idx, w->n);
+
+    paint_stack();
+    measurement_start(m, hw);
+    if (test->column_sort_func) {
+        test->column_sort_func(w->columns, w->idx, w->n, test->cmp_func, comparisons);
+        if (test->gather) {
+            gather_columns(w->columns, w->idx, w->n, w->sorted);
+        }
+    }
+    else {
+        test->index_sort_func(w->original_data, w->idx, w->n, test->cmp_func, comparisons);
+        if (test->gather) {
+            gather_students(w->original_data, w->idx, w->n, w->sorted);
+        }
+    }
+    measurement_stop(m, hw);
+    m->stack_bytes = stack_high_water();
+}
+
+// Affinity mask of a thread before pin_current_thread changed it
+typedef struct {
+    int saved; // 0 if nothing needs restoring
+#if HAVE_PTHREADS && defined(__linux__)
+    cpu_set_t set;
+#endif
+} SavedAffinity;
+
+// Pins the calling thread to one core. Threads it creates inherit the mask, so the
+// parallel sorts of a pinned worker share that core.
+void pin_current_thread(int worker_id, SavedAffinity* previous) {
+    previous->saved = 0;
+#if HAVE_PTHREADS && defined(__linux__)
+    int cpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus <= 0) return;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(previous->set), &previous->set) != 0) return;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(worker_id % cpus, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        fprintf(stderr, "Warning: Could not pin repetition worker %d.\n", worker_id);
+        return;
+    }
+    previous->saved = 1;
+#else
+    (void)worker_id;
+#endif
+}
+
+// Worker 0 runs on the calling thread, which must not stay pinned after the test
+void restore_thread_affinity(const SavedAffinity* previous) {
+#if HAVE_PTHREADS && defined(__linux__)
+    if (previous->saved) pthread_setaffinity_np(pthread_self(), sizeof(previous->set), &previous->set);
+#else
+    (void)previous;
+#endif
+}
+
+void* repetition_worker_main(void* arg) {
+    RepetitionWorker* w = (RepetitionWorker*)arg;
+
+    SavedAffinity affinity = { 0 };
+    if (pin_workers) pin_current_thread(w->worker_id, &affinity);
+
+    long long live_before = alloc_stats.live_bytes;
+    if (!allocate_worker_buffers(w)) {
+        free_worker_buffers(w);
+        restore_thread_affinity(&affinity);
+        w->failed = 1;
+        return NULL;
+    }
+    w->buffer_bytes = (size_t)(alloc_stats.live_bytes - live_before);
+
+    HwCounters hw;
+    Measurement m;
+    hw_counters_open(&hw);
+
+    for (int i = w->worker_id; i < repetition_count; i += w->worker_count) {
+        long long current_comparisons = 0;
+        char_inspections = 0; // Thread-local: this worker's count only
+        alloc_stats_mark();   // Thread-local as well
+        live_before = alloc_stats.live_bytes;
+        run_repetition(w, &current_comparisons, &m, &hw);
+
+        w->comparisons += current_comparisons;
+        w->char_inspections += char_inspections;
+        w->allocations += alloc_stats.allocations;
+        if ((size_t)(alloc_stats.peak_bytes - live_before) > w->peak_heap_bytes) w->peak_heap_bytes = (size_t)(alloc_stats.peak_bytes - live_before);
+        if (m.stack_bytes > w->stack_bytes) w->stack_bytes = m.stack_bytes;
+        w->times[i] = m.elapsed_ns;
+        for (int c = 0; c < HW_COUNTER_COUNT; c++) {
+            // A counter that fails once is reported as unavailable for the whole test
+            if (m.hw[c] < 0 || w->hw_totals[c] < 0) w->hw_totals[c] = -1;
+            else w->hw_totals[c] += m.hw[c];
+        }
+        w->completed++;
+    }
+
+    hw_counters_close(&hw);
+    free_worker_buffers(w);
+    restore_thread_affinity(&affinity);
+    return NULL;
+}
+
+int resolve_worker_count(void) {
+    int workers = repetition_worker_count;
+#if HAVE_PTHREADS
+    if (workers <= 0) workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#else
+    workers = 1;
+#endif
+    if (workers < 1) workers = 1;
+    if (workers > repetition_count) workers = repetition_count;
+    return workers;
+}
+
+void run_test(const Student* original_data, int n, SortTest test, SortMetrics* avg_metrics) {
+    SortMetrics total_metrics = { 0 };
+
+    memset(avg_metrics, 0, sizeof(SortMetrics));
+
+    // Column mode: the columns are built once, outside the measured region, and shared
+    StudentColumns columns;
+    memset(&columns, 0, sizeof(columns));
+    if (test.column_sort_func && !students_to_columns(original_data, n, &columns)) {
+        fprintf(stderr, "Error: Memory allocation failed for student columns.\n");
+        return;
+    }
+
+    uint64_t* times = (uint64_t*)tracked_malloc(sizeof(uint64_t) * repetition_count);
+    int worker_count = resolve_worker_count();
+    RepetitionWorker* workers = (RepetitionWorker*)tracked_calloc(worker_count, sizeof(RepetitionWorker));
+    if (!times || !workers) {
+        fprintf(stderr, "Error: Memory allocation failed for repetition workers.\n");
+        tracked_free(times);
+        tracked_free(workers);
+        free_student_columns(&columns);
+        return;
+    }
+
+    for (int w = 0; w < worker_count; w++) {
+        workers[w].original_data = original_data;
+        workers[w].columns = &columns;
+        workers[w].n = n;
+        workers[w].test = test;
+        workers[w].worker_id = w;
+        workers[w].worker_count = worker_count;
+        workers[w].times = times;
+    }
+
+#if HAVE_PTHREADS
+    pthread_t* threads = (pthread_t*)tracked_malloc(sizeof(pthread_t) * worker_count);
+    int* started = (int*)tracked_calloc(worker_count, sizeof(int));
+    for (int w = 1; threads && started && w < worker_count; w++) {
+        started[w] = pthread_create(&threads[w], NULL, repetition_worker_main, &workers[w]) == 0;
+    }
+    repetition_worker_main(&workers[0]);
+    for (int w = 1; w < worker_count; w++) {
+        if (threads && started && started[w]) pthread_join(threads[w], NULL);
+        else repetition_worker_main(&workers[w]); // Could not spawn: run its share here
+    }
+    tracked_free(threads);
+    tracked_free(started);
+#else
+    repetition_worker_main(&workers[0]);
+#endif
+
+    // Merge per-worker accumulators
+    long long hw_totals[HW_COUNTER_COUNT] = { 0 };
+    int completed = 0;
+    for (int w = 0; w < worker_count; w++) {
+        if (workers[w].failed) {
+            fprintf(stderr, "Error: Memory allocation failed for test run buffers (worker %d).\n", w);
+            continue;
+        }
+        total_metrics.comparisons += workers[w].comparisons;
+        total_metrics.char_inspections += workers[w].char_inspections;
+        total_metrics.allocations += workers[w].allocations;
+        completed += workers[w].completed;
+
+        // Memory and stack are peaks: the largest any worker saw
+        size_t peak = workers[w].buffer_bytes + workers[w].peak_heap_bytes;
+        if (peak > avg_metrics->memory_bytes) avg_metrics->memory_bytes = peak;
+        if (workers[w].stack_bytes > avg_metrics->stack_bytes) avg_metrics->stack_bytes = workers[w].stack_bytes;
+        for (int c = 0; c < HW_COUNTER_COUNT; c++) {
+            if (workers[w].hw_totals[c] < 0 || hw_totals[c] < 0) hw_totals[c] = -1;
+            else hw_totals[c] += workers[w].hw_totals[c];
+        }
+    }
+
+    // Keep only the time slots of workers that ran
+    int sample_count = 0;
+    for (int i = 0; i < repetition_count; i++) {
+        if (!workers[i % worker_count].failed) times[sample_count++] = times[i];
+    }
+
+    // Calculate averages (over the repetitions that actually ran)
+    if (completed > 0) {
+        avg_metrics->comparisons = total_metrics.comparisons / completed;
+        avg_metrics->char_inspections = total_metrics.char_inspections / completed;
+        avg_metrics->allocations = total_metrics.allocations / completed;
+        summarize_times(times, sample_count, avg_metrics);
+    }
+    for (int c = 0; c < HW_COUNTER_COUNT; c++) {
+        avg_metrics->hw[c] = (completed > 0 && hw_totals[c] >= 0) ? hw_totals[c] / completed : -1;
+    }
+
+    tracked_free(workers);
+    tracked_free(times);
+    free_student_columns(&columns);
+}
+
+// Bubble, Insertion, Merge (serial or parallel), LSD radix, the key-extraction sort (direct
+// or indirect) and the B+-tree (ties ordered by index) keep equal keys in input order
+int is_stable_sort(const char* name) {
+    return strcmp(name, "Bubble Sort") == 0 ||
+        strcmp(name, "Insertion Sort") == 0 ||
+        strcmp(name, "Merge Sort") == 0 ||
+        strcmp(name, "Merge Sort (Parallel)") == 0 ||
+        strcmp(name, "Merge Sort (Natural Runs)") == 0 ||
+        strcmp(name, "Merge Sort (Specialized)") == 0 ||
+        strcmp(name, "Insertion Sort (Specialized)") == 0 ||
+        strcmp(name, "Radix Sort (LSD-256)") == 0 ||
+        strcmp(name, "Radix Sort (MSD, Sort Spec)") == 0 ||
+        strcmp(name, "Merge Sort (Columns)") == 0 ||
+        strcmp(name, "Radix Sort (LSD-256, Columns)") == 0 ||
+        strcmp(name, "Key Sort (Packed 64-bit)") == 0 ||
+        strcmp(name, "Insertion Sort (Indirect)") == 0 ||
+        strcmp(name, "Merge Sort (Indirect)") == 0 ||
+        strcmp(name, "Key Sort (Packed 64-bit, Indirect)") == 0 ||
+        strcmp(name, "B+-Tree Sort (Indirect)") == 0;
+}
+
+// Reasons all_tests[] rows are left out of the table; NULL if the test runs
+const char* test_skip_reason(const SortTest* test) {
+    // Heap/Tree are only compared on unique keys
+    if (test->skip_heap_tree) {
+        if (strcmp(test->name, "Heap Sort") == 0 || strcmp(test->name, "Tree Sort (Basic)") == 0 || strcmp(test->name, "AVL Tree Sort (Improved)") == 0) {
+            return "heap/tree sorts run on unique keys only";
+        }
+    }
+
+    // Radix needs a packed integer key (not NAME)
+    if (test->is_radix && key_extractor_for(test->cmp_func) == NULL) {
+        return "no packed integer key for radix sort";
+    }
+
+    // Radix Sort (ID) always sorts by ID ascending
+    if (fixed_sort_key(test) != NULL && fixed_sort_key(test) != test->cmp_func) {
+        return "Radix Sort (ID) sorts by ID ascending only";
+    }
+
+    // GENDER rows compare stable sorts only
+    if (strstr(test->cmp_name, "GENDER") != NULL && !is_stable_sort(test->name)) {
+        return "GENDER rows are for stable sorts only";
+    }
+    return NULL;
+}
+
+
+// --- External Merge Sort (Datasets Larger Than Memory) ---
+// Sorts a student CSV of any size with bounded memory, in two phases:
+//   1. Run formation: the CSV is streamed in chunks that fit the memory budget; each chunk
+//      is sorted with an in-memory sort and spilled to a temporary file as raw Student
+//      records (one run per chunk).
+//   2. Merging: a loser tree merges up to fan_in runs at a time, reading each run through
+//      its own large block buffer. While more runs are left than one pass can take,
+//      intermediate passes merge groups into longer runs; the last pass writes the CSV.
+// A single run skips the temporary files and is written straight from memory. Ties go to
+// the earlier run, so the output is stable whenever the in-memory sort is.
+//   ./sorting_assignment --external sorted.csv --data roster.csv --key total_desc
+//       --memory 8G --temp-dir /scratch
+
+#define EXTERNAL_MEMORY_DEFAULT ((size_t)256 << 20) // Default budget (--memory)
+#define EXTERNAL_IO_BUFFER ((size_t)1 << 20)        // Block size of each run reader and the output
+#define EXTERNAL_MAX_FAN_IN 64                      // Runs merged per pass (bounds the open files)
+#define EXTERNAL_LINE_LEN 1024
+
+typedef struct {
+    size_t memory_bytes;   // Budget for records and I/O buffers
+    const char* temp_dir;  // Where runs are spilled; NULL = $TMPDIR or /tmp
+} ExternalSortConfig;
+
+typedef struct {
+    long long records;
+    long long comparisons;
+    int runs;              // Sorted runs written by phase 1
+    int merge_passes;      // Including the final pass (0 if there was a single run)
+    long long spilled_bytes;
+} ExternalSortStats;
+
+// Opens an anonymous temporary file in dir. On POSIX the file is unlinked right away, so
+// the disk space is released when it is closed, even if the program dies mid-sort.
+FILE* open_run_file(const char* dir) {
+#if !defined(_WIN32)
+    char path[1024];
+    if (!dir) dir = getenv("TMPDIR");
+    if (!dir || !*dir) dir = "/tmp";
+    snprintf(path, sizeof(path), "%s/sort_run_XXXXXX", dir);
+    int fd = mkstemp(path);
+    if (fd < 0) return NULL;
+    unlink(path);
+    FILE* file = fdopen(fd, "w+b");
+    if (!file) close(fd);
+    return file;
+#else
+    (void)dir;
+    return tmpfile();
+#endif
+}
+
+int write_student_csv(FILE* out, const Student* s) {
+    return fprintf(out, "%d,%s,%c,%d,%d,%d\n", s->id, s->name, s->gender, s->korean, s->english, s->math) > 0;
+}
+
+// A sorted run on disk, read back one block of records at a time
+typedef struct {
+    FILE* file;
+    Student* block;
+    size_t block_records;
+    size_t count; // Records in block
+    size_t pos;   // Next record of block
+    int exhausted;
+} RunReader;
+
+// Loads the next record of the run into block[pos]; marks the run exhausted at its end
+int run_reader_advance(RunReader* r) {
+    if (++r->pos < r->count) return 1;
+    r->count = fread(r->block, sizeof(Student), r->block_records, r->file);
+    r->pos = 0;
+    if (r->count == 0) {
+        r->exhausted = 1;
+        return !ferror(r->file);
+    }
+    return 1;
+}
 
-// Structure to define a single sort test case
+// Loser tree over k runs: node t (1 <= t < k) holds the loser of the match played there,
+// leaf i sits at position k + i, and tree[0] is the overall winner. Replacing the winner
+// replays only its leaf-to-root path: ceil(log2 k) comparisons per record.
 typedef struct {
-    char name[50];
-    void (*sort_func)(Student[], int, CompareFunc, long long*);
-    CompareFunc cmp_func;
-    char cmp_name[50];
-    int skip_heap_tree; // 1 if key has duplicates (skip Heap/Tree), 0 otherwise
-    int is_radix; // 1 if Radix sort
-} SortTest;
+    RunReader* runs;
+    int k;
+    int* tree;
+    CompareFunc cmp;
+    long long* comparisons;
+} LoserTree;
+
+// 1 if run a's current record goes before run b's (exhausted runs lose, ties go to the earlier run)
+int loser_tree_beats(const LoserTree* lt, int a, int b) {
+    if (lt->runs[a].exhausted) return 0;
+    if (lt->runs[b].exhausted) return 1;
+    int c = lt->cmp(&lt->runs[a].block[lt->runs[a].pos], &lt->runs[b].block[lt->runs[b].pos], lt->comparisons);
+    return c < 0 || (c == 0 && a < b);
+}
 
-void run_test(const Student* original_data, int n, SortTest test, SortMetrics* avg_metrics) {
-    SortMetrics total_metrics = { 0, 0 };
-    Student* arr = NULL;
+int loser_tree_build(LoserTree* lt, int node) {
+    if (node >= lt->k) return node - lt->k;
+    int a = loser_tree_build(lt, 2 * node);
+    int b = loser_tree_build(lt, 2 * node + 1);
+    if (loser_tree_beats(lt, a, b)) {
+        lt->tree[node] = b;
+        return a;
+    }
+    lt->tree[node] = a;
+    return b;
+}
+
+void loser_tree_replay(LoserTree* lt, int winner) {
+    for (int t = (winner + lt->k) / 2; t > 0; t /= 2) {
+        if (loser_tree_beats(lt, lt->tree[t], winner)) {
+            int loser = winner;
+            winner = lt->tree[t];
+            lt->tree[t] = loser;
+        }
+    }
+    lt->tree[0] = winner;
+}
 
-    // Memory Usage Estimate
-    size_t data_mem = sizeof(Student) * n;
-    size_t aux_mem = 0;
+// Merges runs[0, k) into out: raw records if csv is 0, CSV lines otherwise. Returns the
+// number of records written, or -1 on failure.
+long long merge_runs(FILE* runs[], int k, FILE* out, int csv, size_t block_records, CompareFunc cmp, long long* comparisons) {
+    RunReader* readers = (RunReader*)tracked_calloc((size_t)k, sizeof(RunReader));
+    int* tree = (int*)tracked_malloc(sizeof(int) * (size_t)k);
+    Student* blocks = (Student*)tracked_malloc(sizeof(Student) * block_records * (size_t)k);
+    long long written = -1;
+
+    if (!readers || !tree || !blocks) {
+        fprintf(stderr, "Error: Memory allocation failed for the external merge buffers.\n");
+        goto done;
+    }
 
-    if (strcmp(test.name, "Merge Sort") == 0 || strcmp(test.name, "Radix Sort (ID)") == 0) {
-        aux_mem = sizeof(Student) * n; // Auxiliary array of size N
+    for (int i = 0; i < k; i++) {
+        readers[i].file = runs[i];
+        readers[i].block = blocks + block_records * (size_t)i;
+        readers[i].block_records = block_records;
+        readers[i].pos = 0;
+        readers[i].count = 0;
+        rewind(runs[i]);
+        if (!run_reader_advance(&readers[i])) goto read_error;
     }
-    if (strcmp(test.name, "Tree Sort (Basic)") == 0 || strcmp(test.name, "AVL Tree Sort (Improved)") == 0) {
-        // Tree nodes are larger than Student struct. Estimate N * (sizeof(TreeNode))
-        aux_mem = sizeof(TreeNode) * n;
+
+    LoserTree lt = { readers, k, tree, cmp, comparisons };
+    tree[0] = loser_tree_build(&lt, 1);
+    written = 0;
+
+    while (!readers[tree[0]].exhausted) {
+        RunReader* r = &readers[tree[0]];
+        const Student* s = &r->block[r->pos];
+        if (csv ? !write_student_csv(out, s) : fwrite(s, sizeof(Student), 1, out) != 1) {
+            fprintf(stderr, "Error: Write failed during the external merge.\n");
+            written = -1;
+            goto done;
+        }
+        written++;
+        if (!run_reader_advance(r)) goto read_error;
+        loser_tree_replay(&lt, tree[0]);
     }
-    avg_metrics->memory_bytes = data_mem + aux_mem;
+    goto done;
+
+read_error:
+    fprintf(stderr, "Error: Read failed on a temporary run file.\n");
+    written = -1;
+done:
+    tracked_free(readers);
+    tracked_free(tree);
+    tracked_free(blocks);
+    return written;
+}
 
+// Reads up to capacity records from the CSV stream; returns the count (0 at end of input)
+int read_student_chunk(FILE* in, Student chunk[], int capacity, int* read_error) {
+    char line[EXTERNAL_LINE_LEN];
+    int count = 0;
 
-    for (int i = 0; i < NUM_REPETITIONS; i++) {
-        // 1. Copy original data for each run
-        arr = (Student*)malloc(data_mem);
-        if (!arr) {
-            fprintf(stderr, "Error: Memory allocation failed for test run copy.\n");
-            // Fallback: Use accumulated average and return
-            if (i > 0) total_metrics.comparisons /= i;
-            avg_metrics->comparisons = total_metrics.comparisons;
-            return;
+    while (count < capacity && fgets(line, sizeof(line), in)) {
+        size_t len = strlen(line);
+        if (len > 0 && line[len - 1] == '\n') {
+            line[--len] = '\0';
+        }
+        else if (!feof(in)) {
+            // Over-long line: drop the rest of it rather than parsing it as a new record
+            int c;
+            while ((c = fgetc(in)) != EOF && c != '\n') {}
         }
-        memcpy(arr, original_data, data_mem);
+        if (parse_student_line(line, line + len, &chunk[count])) count++;
+    }
+    if (ferror(in)) *read_error = 1;
+    return count;
+}
 
-        // 2. Perform the sort and track comparisons
-        long long current_comparisons = 0;
-        test.sort_func(arr, n, test.cmp_func, &current_comparisons);
-        total_metrics.comparisons += current_comparisons;
+int external_sort(const char* input_path, const char* output_path, SortFunc sort, CompareFunc cmp,
+    const ExternalSortConfig* cfg, ExternalSortStats* stats) {
+    size_t memory = cfg->memory_bytes > 0 ? cfg->memory_bytes : EXTERNAL_MEMORY_DEFAULT;
+    memset(stats, 0, sizeof(*stats));
+
+    // Half of the budget holds the chunk; the other half is left for the in-memory sort's
+    // auxiliary space (merge sort copies up to n records)
+    size_t chunk_records = memory / 2 / sizeof(Student);
+    if (chunk_records > INT_MAX) chunk_records = INT_MAX;
+    if (chunk_records < 1024) chunk_records = 1024;
+
+    // The merge gives each input run and the output one buffer
+    size_t io_buffer = EXTERNAL_IO_BUFFER;
+    int fan_in = (int)(memory / io_buffer) - 1;
+    if (fan_in > EXTERNAL_MAX_FAN_IN) fan_in = EXTERNAL_MAX_FAN_IN;
+    if (fan_in < 2) {
+        fan_in = 2;
+        io_buffer = memory / 3 > sizeof(Student) ? memory / 3 : sizeof(Student);
+    }
+    size_t block_records = io_buffer / sizeof(Student);
+
+    FILE* in = fopen(input_path, "r");
+    if (!in) {
+        fprintf(stderr, "Error: Could not open input file %s\n", input_path);
+        return 0;
+    }
+    char* in_buffer = (char*)tracked_malloc(io_buffer);
+    if (in_buffer) setvbuf(in, in_buffer, _IOFBF, io_buffer);
+
+    char header[EXTERNAL_LINE_LEN] = "";
+    if (!fgets(header, sizeof(header), in)) header[0] = '\0';
+
+    Student* chunk = (Student*)tracked_malloc(sizeof(Student) * chunk_records);
+    FILE** runs = NULL;
+    int run_capacity = 0;
+    FILE* out = NULL;
+    char* out_buffer = NULL;
+    int ok = 0;
+    int read_error = 0;
+
+    if (!chunk) {
+        fprintf(stderr, "Error: Memory allocation failed for a %zu-record external sort chunk.\n", chunk_records);
+        goto cleanup;
+    }
+
+    // Phase 1: sorted runs
+    int n;
+    while ((n = read_student_chunk(in, chunk, (int)chunk_records, &read_error)) > 0) {
+        sort(chunk, n, cmp, &stats->comparisons);
+        stats->records += n;
+
+        if (stats->runs == 0 && (size_t)n < chunk_records && !read_error) break; // Whole input fits
+
+        if (stats->runs == run_capacity) {
+            run_capacity = run_capacity ? run_capacity * 2 : 16;
+            FILE** grown = (FILE**)tracked_realloc(runs, sizeof(FILE*) * (size_t)run_capacity);
+            if (!grown) {
+                fprintf(stderr, "Error: Memory allocation failed for the run list.\n");
+                goto cleanup;
+            }
+            runs = grown;
+        }
+        FILE* run = open_run_file(cfg->temp_dir);
+        if (!run) {
+            fprintf(stderr, "Error: Could not create a temporary run file in %s\n", cfg->temp_dir ? cfg->temp_dir : "$TMPDIR");
+            goto cleanup;
+        }
+        runs[stats->runs++] = run;
+        if (fwrite(chunk, sizeof(Student), (size_t)n, run) != (size_t)n || fflush(run) != 0) {
+            fprintf(stderr, "Error: Write failed on a temporary run file (disk full?).\n");
+            goto cleanup;
+        }
+        stats->spilled_bytes += (long long)sizeof(Student) * n;
+    }
+    if (read_error) {
+        fprintf(stderr, "Error: Read failed on %s\n", input_path);
+        goto cleanup;
+    }
+    fclose(in);
+    in = NULL;
+    tracked_free(in_buffer);
+    in_buffer = NULL;
+
+    out = fopen(output_path, "w");
+    if (!out) {
+        fprintf(stderr, "Error: Could not open output file %s\n", output_path);
+        goto cleanup;
+    }
+    out_buffer = (char*)tracked_malloc(io_buffer);
+    if (out_buffer) setvbuf(out, out_buffer, _IOFBF, io_buffer);
+    if (header[0] != '\0') fputs(header, out);
+
+    if (stats->runs == 0) {
+        // Single chunk: no temporary files at all
+        for (long long i = 0; i < stats->records; i++) {
+            if (!write_student_csv(out, &chunk[i])) {
+                fprintf(stderr, "Error: Write failed on %s\n", output_path);
+                goto cleanup;
+            }
+        }
+        ok = 1;
+        goto cleanup;
+    }
+
+    // The chunk is no longer needed; its memory goes to the merge buffers
+    tracked_free(chunk);
+    chunk = NULL;
+
+    // Phase 2: intermediate passes until one pass can take every run
+    int run_count = stats->runs;
+    while (run_count > fan_in) {
+        int merged = 0;
+        for (int first = 0; first < run_count; first += fan_in) {
+            int k = run_count - first < fan_in ? run_count - first : fan_in;
+            FILE* target = runs[first];
+            if (k > 1) {
+                target = open_run_file(cfg->temp_dir);
+                if (!target) {
+                    fprintf(stderr, "Error: Could not create a temporary run file.\n");
+                    goto cleanup;
+                }
+                long long written = merge_runs(&runs[first], k, target, 0, block_records, cmp, &stats->comparisons);
+                for (int i = first; i < first + k; i++) {
+                    fclose(runs[i]);
+                    runs[i] = NULL;
+                }
+                if (written < 0 || fflush(target) != 0) {
+                    fclose(target);
+                    goto cleanup;
+                }
+                stats->spilled_bytes += (long long)sizeof(Student) * written;
+            }
+            runs[merged++] = target;
+        }
+        for (int i = merged; i < run_count; i++) runs[i] = NULL;
+        run_count = merged;
+        stats->merge_passes++;
+    }
+
+    if (merge_runs(runs, run_count, out, 1, block_records, cmp, &stats->comparisons) < 0) goto cleanup;
+    stats->merge_passes++;
+    ok = 1;
+
+cleanup:
+    if (out && fclose(out) != 0 && ok) {
+        fprintf(stderr, "Error: Write failed on %s\n", output_path);
+        ok = 0;
+    }
+    for (int i = 0; i < stats->runs && runs; i++) {
+        if (runs[i]) fclose(runs[i]);
+    }
+    tracked_free(runs);
+    tracked_free(chunk);
+    tracked_free(out_buffer);
+    if (in) fclose(in);
+    tracked_free(in_buffer);
+    return ok;
+}
+
+
+// --- Benchmark Runner (Command Line) ---
+// With arguments, main() sweeps algorithms x keys x sizes x distributions instead of the
+// fixed all_tests[] table and writes one row per point as CSV, JSON or Markdown, e.g.
+//   ./sorting_assignment --algo merge,intro --key id_asc,total_desc --n 1e3,1e4,1e5
+//       --dist file,random --reps 20 --threads 8 --format csv --output scaling.csv
+// A spec file (--spec FILE) holds the same options as "option=value" lines; # starts a comment.
+
+#define RUNNER_MAX_ITEMS 64
+#define RUNNER_TOKEN_LEN 64
+
+typedef struct {
+    const char* id;  // Name used on the command line
+    SortTest test;   // Algorithm and mode; the key fields are filled in per key
+} AlgorithmEntry;
+
+typedef struct {
+    const char* id;
+    CompareFunc cmp;
+    const char* cmp_name;
+    int has_duplicates;
+} KeyEntry;
+
+typedef void (*StudentSortFunc)(Student[], int, CompareFunc, long long*);
+
+const AlgorithmEntry algorithm_registry[] = {
+    { "bubble", {.name = "Bubble Sort", .sort_func = bubble_sort} },
+    { "selection", {.name = "Selection Sort", .sort_func = selection_sort} },
+    { "insertion", {.name = "Insertion Sort", .sort_func = insertion_sort} },
+    { "shell", {.name = "Shell Sort (Basic)", .sort_func = shell_sort_basic} },
+    { "shell-knuth", {.name = "Shell Sort (Improved)", .sort_func = shell_sort_improved} },
+    { "shell-ciura", {.name = "Shell Sort (Ciura, Extended)", .sort_func = shell_sort_ciura} },
+    { "shell-tokuda", {.name = "Shell Sort (Tokuda)", .sort_func = shell_sort_tokuda} },
+    { "shell-sedgewick", {.name = "Shell Sort (Sedgewick)", .sort_func = shell_sort_sedgewick} },
+    { "shell-pratt", {.name = "Shell Sort (Pratt)", .sort_func = shell_sort_pratt} },
+    { "quick", {.name = "Quick Sort (Basic)", .sort_func = quick_sort_basic} },
+    { "quick-median", {.name = "Quick Sort (Improved)", .sort_func = quick_sort_improved} },
+    { "intro", {.name = "Quick Sort (Introsort)", .sort_func = intro_sort} },
+    { "heap", {.name = "Heap Sort", .sort_func = heap_sort} },
+    { "topk", {.name = "Top-k Partial Sort", .sort_func = top_k} },
+    { "topk-select", {.name = "Top-k Partial Sort (Introselect)", .sort_func = top_k_introselect} },
+    { "nth", {.name = "Nth Element (Median)", .sort_func = nth_element_median} },
+    { "heap2", {.name = "Heap Sort (2-ary, Bottom-Up)", .sort_func = heap_sort_binary} },
+    { "heap4", {.name = "Heap Sort (4-ary, Bottom-Up)", .sort_func = heap_sort_4ary} },
+    { "heap8", {.name = "Heap Sort (8-ary, Bottom-Up)", .sort_func = heap_sort_8ary} },
+    { "merge", {.name = "Merge Sort", .sort_func = merge_sort} },
+    { "merge-natural", {.name = "Merge Sort (Natural Runs)", .sort_func = natural_merge_sort} },
+    { "merge-parallel", {.name = "Merge Sort (Parallel)", .sort_func = merge_sort_parallel} },
+    { "radix-id", {.name = "Radix Sort (ID)", .sort_func = (StudentSortFunc)radix_sort_id, .is_radix = 1} },
+    { "radix", {.name = "Radix Sort (LSD-256)", .sort_func = radix_sort_key, .is_radix = 1} },
+    { "radix-msd", {.name = "Radix Sort (MSD, Sort Spec)", .sort_func = radix_sort_spec} },
+    { "name-mkqs", {.name = "String Sort (Multikey Quicksort)", .sort_func = name_string_sort} },
+    { "tree", {.name = "Tree Sort (Basic)", .sort_func = tree_sort_basic} },
+    { "avl", {.name = "AVL Tree Sort (Improved)", .sort_func = avl_tree_sort} },
+    { "key", {.name = "Key Sort (Packed 64-bit)", .sort_func = key_sort} },
+    { "insertion-spec", {.name = "Insertion Sort (Specialized)", .sort_func = insertion_sort_specialized} },
+    { "shell-spec", {.name = "Shell Sort (Improved, Specialized)", .sort_func = shell_sort_specialized} },
+    { "heap-spec", {.name = "Heap Sort (Specialized)", .sort_func = heap_sort_specialized} },
+    { "intro-spec", {.name = "Quick Sort (Introsort, Specialized)", .sort_func = intro_sort_specialized} },
+    { "merge-spec", {.name = "Merge Sort (Specialized)", .sort_func = merge_sort_specialized} },
+    { "quick-indirect", {.name = "Quick Sort (Basic, Indirect)", .index_sort_func = quick_sort_basic_indirect, .gather = 1} },
+    { "heap-indirect", {.name = "Heap Sort (Indirect)", .index_sort_func = heap_sort_indirect, .gather = 1} },
+    { "merge-indirect", {.name = "Merge Sort (Indirect)", .index_sort_func = merge_sort_indirect, .gather = 1} },
+    { "key-indirect", {.name = "Key Sort (Packed 64-bit, Indirect)", .index_sort_func = key_sort_indirect, .gather = 1} },
+    { "bptree", {.name = "B+-Tree Sort (Indirect)", .index_sort_func = bptree_sort_indirect, .gather = 1} },
+    { "merge-columns", {.name = "Merge Sort (Columns)", .gather = 1, .column_sort_func = column_merge_sort} },
+    { "radix-columns", {.name = "Radix Sort (LSD-256, Columns)", .is_radix = 1, .gather = 1, .column_sort_func = column_radix_sort} },
+};
+
+const KeyEntry key_registry[] = {
+    { "id_asc", compare_id_asc, "ID Ascending", 0 },
+    { "id_desc", compare_id_desc, "ID Descending", 0 },
+    { "name_asc", compare_name_asc, "NAME Ascending", 1 },
+    { "name_desc", compare_name_desc, "NAME Descending", 1 },
+    { "gender_asc", compare_gender_asc, "GENDER Ascending", 1 },
+    { "gender_desc", compare_gender_desc, "GENDER Descending", 1 },
+    { "total_asc", compare_total_asc, "TOTAL Ascending", 1 },
+    { "total_desc", compare_total_desc, "TOTAL Descending", 1 },
+    { "order", compare_active_spec, "Sort Spec (--order)", 1 }, // Set by --order
+};
+
+// Distribution 0 repeats the data file; 1 + d is data_generator.h's distribution d
+#define RUNNER_DIST_FILE 0
+#define RUNNER_DEFAULT_SEED 20240601ull
+
+const char* runner_distribution_name(int distribution) {
+    return distribution == RUNNER_DIST_FILE ? "file" : data_distribution_names[distribution - 1];
+}
+
+#define ALGORITHM_COUNT ((int)(sizeof(algorithm_registry) / sizeof(algorithm_registry[0])))
+#define KEY_COUNT ((int)(sizeof(key_registry) / sizeof(key_registry[0])))
+#define DISTRIBUTION_COUNT (1 + DIST_COUNT)
+
+typedef enum { FORMAT_MARKDOWN, FORMAT_CSV, FORMAT_JSON } OutputFormat;
+
+typedef struct {
+    int algorithms[RUNNER_MAX_ITEMS]; // Indices into algorithm_registry
+    int algorithm_count;
+    int keys[RUNNER_MAX_ITEMS];       // Indices into key_registry
+    int key_count;
+    int sizes[RUNNER_MAX_ITEMS];      // 0 = every record of the data file
+    int size_count;
+    int distributions[RUNNER_MAX_ITEMS];
+    int distribution_count;
+    uint64_t seed;                    // Seed of the generated distributions
+    OutputFormat format;
+    char output_path[512];            // Empty = stdout
+    char data_path[512];
+    char external_path[512];          // Non-empty: external sort of the data file into this CSV
+    char temp_dir[512];               // Empty = $TMPDIR or /tmp
+    size_t memory_bytes;              // External sort budget, 0 = EXTERNAL_MEMORY_DEFAULT
+    IndexQuery queries[RUNNER_MAX_ITEMS]; // Non-empty: key index lookups instead of benchmarking
+    char query_text[RUNNER_MAX_ITEMS][RUNNER_TOKEN_LEN];
+    int query_count;
+} RunnerConfig;
+
+void print_runner_usage(FILE* out) {
+    fprintf(out,
+        "Usage: sorting_assignment [options]\n"
+        "  (no options)           run the built-in Assignment A & B table\n"
+        "  --algo LIST            algorithms, comma separated, or 'all'\n"
+        "  --key LIST             sort keys, comma separated, or 'all' (default id_asc)\n"
+        "  --n LIST               input sizes, e.g. 1000,1e5,1e6 (default: all rows of the data file)\n"
+        "  --dist LIST            input distributions, or 'all' (default file, see --list)\n"
+        "  --seed N               seed of the generated distributions (default %llu)\n"
+        "  --reps N               repetitions per point (default %d)\n"
+        "  --top-k K              records placed by topk and topk-select (default %d)\n"
+        "  --order SPEC           adds key 'order': columns with directions, e.g. gender:asc,total:desc,name:asc\n"
+        "  --threads N            threads for the parallel sorts (0 = all CPUs)\n"
+        "  --workers N            threads running repetitions concurrently (0 = all CPUs)\n"
+        "  --pin 0|1              pin each repetition worker to its own core (Linux only, default %d)\n"
+        "  --format FMT           csv, json or markdown (default markdown)\n"
+        "  --output FILE, -o FILE write results to FILE instead of stdout\n"
+        "  --data FILE            CSV data file (default %s)\n"
+        "  --spec FILE            read option=value lines from FILE\n"
+        "  --list                 list algorithms, keys and distributions\n"
+        "  --external FILE        sort the data file into FILE with bounded memory, using the first\n"
+        "                         --algo (default merge) and --key instead of benchmarking\n"
+        "  --memory SIZE          external sort memory budget, e.g. 512M or 8G (default %zuM)\n"
+        "  --temp-dir DIR         directory for the external sort's temporary runs\n"
+        "  --query LIST           look records up in the data file's key index (built and saved as\n"
+        "                         <data>%s on first use): id=X, id=A..B, total=A..B, name=PREFIX*, name=NAME\n",
+        (unsigned long long)RUNNER_DEFAULT_SEED, NUM_REPETITIONS, TOP_K_DEFAULT, PIN_WORKERS, DATA_FILENAME, EXTERNAL_MEMORY_DEFAULT >> 20,
+        INDEX_SUFFIX);
+}
+
+void print_runner_registries(FILE* out) {
+    fprintf(out, "Algorithms:\n");
+    for (int i = 0; i < ALGORITHM_COUNT; i++) {
+        fprintf(out, "  %-16s %s\n", algorithm_registry[i].id, algorithm_registry[i].test.name);
+    }
+    fprintf(out, "Keys:\n");
+    for (int i = 0; i < KEY_COUNT; i++) {
+        fprintf(out, "  %-16s %s\n", key_registry[i].id, key_registry[i].cmp_name);
+    }
+    fprintf(out, "Distributions:\n");
+    for (int i = 0; i < DISTRIBUTION_COUNT; i++) {
+        fprintf(out, "  %s\n", runner_distribution_name(i));
+    }
+}
+
+// Calls handle(cfg, token) for each comma-separated token of list; stops at the first failure
+int for_each_list_item(RunnerConfig* cfg, const char* list, int (*handle)(RunnerConfig*, const char*)) {
+    const char* p = list;
+    while (1) {
+        const char* comma = strchr(p, ',');
+        size_t len = comma ? (size_t)(comma - p) : strlen(p);
+        while (len > 0 && (*p == ' ' || *p == '\t')) { p++; len--; }
+        while (len > 0 && (p[len - 1] == ' ' || p[len - 1] == '\t')) len--;
+        char token[RUNNER_TOKEN_LEN];
+        if (len >= sizeof(token)) {
+            fprintf(stderr, "Error: List item too long in '%s'.\n", list);
+            return 0;
+        }
+        memcpy(token, p, len);
+        token[len] = '\0';
+        if (len > 0 && !handle(cfg, token)) return 0;
+        if (!comma) return 1;
+        p = comma + 1;
+    }
+}
+
+int append_index(int list[], int* count, int index) {
+    if (*count >= RUNNER_MAX_ITEMS) {
+        fprintf(stderr, "Error: Too many items in one option (max %d).\n", RUNNER_MAX_ITEMS);
+        return 0;
+    }
+    list[(*count)++] = index;
+    return 1;
+}
+
+int add_algorithm(RunnerConfig* cfg, const char* token) {
+    if (strcmp(token, "all") == 0) {
+        for (int i = 0; i < ALGORITHM_COUNT; i++) {
+            if (!append_index(cfg->algorithms, &cfg->algorithm_count, i)) return 0;
+        }
+        return 1;
+    }
+    for (int i = 0; i < ALGORITHM_COUNT; i++) {
+        if (strcmp(token, algorithm_registry[i].id) == 0) return append_index(cfg->algorithms, &cfg->algorithm_count, i);
+    }
+    fprintf(stderr, "Error: Unknown algorithm '%s' (see --list).\n", token);
+    return 0;
+}
+
+int add_key(RunnerConfig* cfg, const char* token) {
+    if (strcmp(token, "all") == 0) {
+        for (int i = 0; i < KEY_COUNT; i++) {
+            if (key_registry[i].cmp == compare_active_spec) continue; // Only through --order
+            if (!append_index(cfg->keys, &cfg->key_count, i)) return 0;
+        }
+        return 1;
+    }
+    for (int i = 0; i < KEY_COUNT; i++) {
+        if (strcmp(token, key_registry[i].id) != 0) continue;
+        if (key_registry[i].cmp == compare_active_spec && active_sort_spec.count == 0) {
+            fprintf(stderr, "Error: Key 'order' needs --order SPEC.\n");
+            return 0;
+        }
+        return append_index(cfg->keys, &cfg->key_count, i);
+    }
+    fprintf(stderr, "Error: Unknown key '%s' (see --list).\n", token);
+    return 0;
+}
+
+int add_distribution(RunnerConfig* cfg, const char* token) {
+    if (strcmp(token, "all") == 0) {
+        for (int i = 0; i < DISTRIBUTION_COUNT; i++) {
+            if (!append_index(cfg->distributions, &cfg->distribution_count, i)) return 0;
+        }
+        return 1;
+    }
+    for (int i = 0; i < DISTRIBUTION_COUNT; i++) {
+        if (strcmp(token, runner_distribution_name(i)) == 0) return append_index(cfg->distributions, &cfg->distribution_count, i);
+    }
+    fprintf(stderr, "Error: Unknown distribution '%s' (see --list).\n", token);
+    return 0;
+}
+
+// Accepts plain integers and scientific notation (1e6) up to INT_MAX
+int parse_count(const char* text, int min_value, int* out) {
+    char* end;
+    double value = strtod(text, &end);
+    if (end == text || *end != '\0' || value < min_value || value > 2147483647.0 || value != floor(value)) {
+        fprintf(stderr, "Error: Invalid count '%s'.\n", text);
+        return 0;
+    }
+    *out = (int)value;
+    return 1;
+}
+
+// Byte count with an optional K, M or G suffix (powers of 1024)
+int parse_byte_size(const char* text, size_t* out) {
+    char* end;
+    double value = strtod(text, &end);
+    double scale = 1.0;
+    if (*end == 'K' || *end == 'k') scale = 1024.0;
+    else if (*end == 'M' || *end == 'm') scale = 1024.0 * 1024.0;
+    else if (*end == 'G' || *end == 'g') scale = 1024.0 * 1024.0 * 1024.0;
+    if (scale > 1.0) end++;
+    if (*end == 'B' || *end == 'b') end++;
+
+    value *= scale;
+    if (end == text || *end != '\0' || value < 1.0 || value > (double)SIZE_MAX) {
+        fprintf(stderr, "Error: Invalid size '%s'.\n", text);
+        return 0;
+    }
+    *out = (size_t)value;
+    return 1;
+}
+
+int add_query(RunnerConfig* cfg, const char* token) {
+    if (cfg->query_count >= RUNNER_MAX_ITEMS) {
+        fprintf(stderr, "Error: Too many items in one option (max %d).\n", RUNNER_MAX_ITEMS);
+        return 0;
+    }
+    if (!parse_index_query(token, &cfg->queries[cfg->query_count])) {
+        fprintf(stderr, "Error: Invalid query '%s' (id=X, id=A..B, total=A..B, name=PREFIX* or name=NAME).\n", token);
+        return 0;
+    }
+    strcpy(cfg->query_text[cfg->query_count++], token);
+    return 1;
+}
+
+int add_size(RunnerConfig* cfg, const char* token) {
+    int n;
+    if (!parse_count(token, 1, &n)) return 0;
+    return append_index(cfg->sizes, &cfg->size_count, n);
+}
+
+int load_runner_spec(RunnerConfig* cfg, const char* path);
+
+// Applies one option (name without the leading dashes); returns 0 on error
+int apply_runner_option(RunnerConfig* cfg, const char* name, const char* value) {
+    if (strcmp(name, "algo") == 0) return for_each_list_item(cfg, value, add_algorithm);
+    if (strcmp(name, "key") == 0) return for_each_list_item(cfg, value, add_key);
+    if (strcmp(name, "n") == 0) return for_each_list_item(cfg, value, add_size);
+    if (strcmp(name, "dist") == 0) return for_each_list_item(cfg, value, add_distribution);
+    if (strcmp(name, "query") == 0) return for_each_list_item(cfg, value, add_query);
+    if (strcmp(name, "reps") == 0) return parse_count(value, 1, &repetition_count);
+    if (strcmp(name, "top-k") == 0) return parse_count(value, 1, &top_k_count);
+    if (strcmp(name, "threads") == 0) return parse_count(value, 0, &sort_thread_count);
+    if (strcmp(name, "workers") == 0) return parse_count(value, 0, &repetition_worker_count);
+    if (strcmp(name, "pin") == 0) {
+        if (strcmp(value, "0") != 0 && strcmp(value, "1") != 0) {
+            fprintf(stderr, "Error: --pin must be 0 or 1, got '%s'.\n", value);
+            return 0;
+        }
+        pin_workers = value[0] == '1';
+        return 1;
+    }
+    if (strcmp(name, "spec") == 0) return load_runner_spec(cfg, value);
+    if (strcmp(name, "memory") == 0) return parse_byte_size(value, &cfg->memory_bytes);
+    if (strcmp(name, "order") == 0) {
+        if (strlen(value) >= sizeof(active_sort_spec_text) || !parse_sort_spec(value, &active_sort_spec)) {
+            fprintf(stderr, "Error: Invalid --order '%s'.\n", value);
+            return 0;
+        }
+        strcpy(active_sort_spec_text, value);
+        return add_key(cfg, "order");
+    }
+    if (strcmp(name, "seed") == 0) {
+        char* end;
+        cfg->seed = strtoull(value, &end, 0);
+        if (end == value || *end != '\0') {
+            fprintf(stderr, "Error: Invalid seed '%s'.\n", value);
+            return 0;
+        }
+        return 1;
+    }
+    if (strcmp(name, "format") == 0) {
+        if (strcmp(value, "csv") == 0) cfg->format = FORMAT_CSV;
+        else if (strcmp(value, "json") == 0) cfg->format = FORMAT_JSON;
+        else if (strcmp(value, "markdown") == 0) cfg->format = FORMAT_MARKDOWN;
+        else {
+            fprintf(stderr, "Error: Unknown format '%s' (csv, json or markdown).\n", value);
+            return 0;
+        }
+        return 1;
+    }
+    if (strcmp(name, "output") == 0 || strcmp(name, "data") == 0 || strcmp(name, "external") == 0 ||
+        strcmp(name, "temp-dir") == 0) {
+        char* dest = name[0] == 'o' ? cfg->output_path : name[0] == 'd' ? cfg->data_path :
+            name[0] == 'e' ? cfg->external_path : cfg->temp_dir;
+        if (strlen(value) >= sizeof(cfg->output_path)) {
+            fprintf(stderr, "Error: Path too long for --%s.\n", name);
+            return 0;
+        }
+        strcpy(dest, value);
+        return 1;
+    }
+    fprintf(stderr, "Error: Unknown option '%s'.\n", name);
+    return 0;
+}
+
+int load_runner_spec(RunnerConfig* cfg, const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "Error: Could not open spec file %s\n", path);
+        return 0;
+    }
+
+    char line[1024];
+    int line_number = 0;
+    int ok = 1;
+    while (ok && fgets(line, sizeof(line), file)) {
+        line_number++;
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        // Trim whitespace at both ends
+        char* start = line;
+        while (*start == ' ' || *start == '\t') start++;
+        char* end = start + strlen(start);
+        while (end > start && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t')) *--end = '\0';
+        if (*start == '\0') continue;
+
+        char* eq = strchr(start, '=');
+        if (!eq) {
+            fprintf(stderr, "Error: %s:%d: expected option=value\n", path, line_number);
+            ok = 0;
+            break;
+        }
+        *eq = '\0';
+        char* name_end = eq;
+        while (name_end > start && (name_end[-1] == ' ' || name_end[-1] == '\t')) *--name_end = '\0';
+        char* value = eq + 1;
+        while (*value == ' ' || *value == '\t') value++;
+
+        ok = apply_runner_option(cfg, start, value);
+    }
+
+    fclose(file);
+    return ok;
+}
+
+// Builds an input of n records. "file" repeats the data file, shifting the IDs of every
+// copy past the previous one so ID stays a unique key. The generated distributions shape the
+// ID column (values in 1..n) with data_generator.h; names, gender and grades are uniform.
+// The same seed gives the same records for every algorithm and key.
+Student* build_runner_input(int distribution, int n, const Student* source, int source_count, uint64_t seed) {
+    Student* data = (Student*)tracked_malloc(sizeof(Student) * (n > 0 ? n : 1));
+    if (!data) {
+        fprintf(stderr, "Error: Memory allocation failed for %d input records.\n", n);
+        return NULL;
+    }
+
+    if (distribution == RUNNER_DIST_FILE) {
+        int min_id = source[0].id;
+        int max_id = source[0].id;
+        for (int i = 1; i < source_count; i++) {
+            if (source[i].id < min_id) min_id = source[i].id;
+            if (source[i].id > max_id) max_id = source[i].id;
+        }
+        long long span = (long long)max_id - min_id + 1;
+        for (int i = 0; i < n; i++) {
+            data[i] = source[i % source_count];
+            data[i].id = (int)(data[i].id + (i / source_count) * span);
+        }
+        return data;
+    }
+
+    // The ID column is generated in place: each int lands in the first field of its record
+    int* ids = (int*)tracked_malloc(sizeof(int) * (n > 0 ? n : 1));
+    if (!ids || !generate_int_data(ids, (size_t)n, n - 1, (DataDistribution)(distribution - 1), seed)) {
+        fprintf(stderr, "Error: Could not generate %s input.\n", runner_distribution_name(distribution));
+        tracked_free(ids);
+        tracked_free(data);
+        return NULL;
+    }
+
+    Xoshiro256 rng;
+    xoshiro_seed(&rng, seed ^ 0x53545544454E5453ull); // Independent stream for the other fields
+    for (int i = 0; i < n; i++) {
+        Student* s = &data[i];
+        memset(s, 0, sizeof(Student));
+        s->id = ids[i] + 1;
+        int name_len = 4 + (int)xoshiro_below(&rng, 6);
+        for (int c = 0; c < name_len; c++) s->name[c] = (char)('a' + xoshiro_below(&rng, 26));
+        s->gender = xoshiro_below(&rng, 2) ? 'M' : 'F';
+        s->korean = (int)xoshiro_below(&rng, 101);
+        s->english = (int)xoshiro_below(&rng, 101);
+        s->math = (int)xoshiro_below(&rng, 101);
+        s->total_grade = s->korean + s->english + s->math;
+    }
+
+    tracked_free(ids);
+    return data;
+}
+
+void write_result_header(FILE* out, OutputFormat format) {
+    if (format == FORMAT_CSV) {
+        fprintf(out, "algorithm,key,n,distribution,seed,repetitions,threads,workers,stable,comparisons,char_inspections,memory_bytes,"
+            "allocations,stack_bytes,time_min_ns,time_median_ns,time_p99_ns,cycles,instructions,branch_misses,llc_misses\n");
+    }
+    else if (format == FORMAT_JSON) {
+        fprintf(out, "[\n");
+    }
+    else {
+        fprintf(out, "| Algorithm | Criterion | N | Distribution | Stable Sort | Comparisons (Avg) | Char Inspections (Avg) | Peak Memory (Bytes) "
+            "| Allocations (Avg) | Peak Stack (Bytes) | Time Min (ns) | Time Median (ns) | Time P99 (ns) | %s | %s | %s | %s |\n",
+            hw_counter_names[0], hw_counter_names[1], hw_counter_names[2], hw_counter_names[3]);
+        fprintf(out, "|:---|:---|:---:|:---|:---|:---:|:---:|:---:|:---:|:---:|:---:|:---:|:---:|:---:|:---:|:---:|:---:|\n");
+    }
+}
+
+void write_result_row(FILE* out, OutputFormat format, int row, const SortTest* test, const char* key_id,
+    const char* distribution, uint64_t seed, int n, const SortMetrics* metrics) {
+    const char* stable = is_stable_sort(test->name) ? "YES" : "NO";
+
+    if (format == FORMAT_CSV) {
+        fprintf(out, "\"%s\",%s,%d,%s,%llu,%d,%d,%d,%s,%lld,%lld,%zu,%lld,",
+            test->name, key_id, n, distribution, (unsigned long long)seed, repetition_count, resolve_thread_count(), resolve_worker_count(),
+            stable, metrics->comparisons, metrics->char_inspections, metrics->memory_bytes, metrics->allocations);
+        if (metrics->stack_bytes != STACK_SATURATED) fprintf(out, "%zu", metrics->stack_bytes); // Empty when saturated
+        fprintf(out, ",%.0f,%.0f,%.0f", metrics->time_min_ns, metrics->time_median_ns, metrics->time_p99_ns);
+        for (int c = 0; c < HW_COUNTER_COUNT; c++) {
+            if (metrics->hw[c] < 0) fprintf(out, ",");
+            else fprintf(out, ",%lld", metrics->hw[c]);
+        }
+        fprintf(out, "\n");
+    }
+    else if (format == FORMAT_JSON) {
+        static const char* hw_keys[HW_COUNTER_COUNT] = { "cycles", "instructions", "branch_misses", "llc_misses" };
+        fprintf(out, "%s  {\"algorithm\": \"%s\", \"key\": \"%s\", \"n\": %d, \"distribution\": \"%s\", \"seed\": %llu, "
+            "\"repetitions\": %d, \"threads\": %d, \"workers\": %d, \"stable\": %s, \"comparisons\": %lld, "
+            "\"char_inspections\": %lld, \"memory_bytes\": %zu, \"allocations\": %lld, ",
+            row > 0 ? ",\n" : "", test->name, key_id, n, distribution, (unsigned long long)seed, repetition_count, resolve_thread_count(),
+            resolve_worker_count(), is_stable_sort(test->name) ? "true" : "false", metrics->comparisons,
+            metrics->char_inspections, metrics->memory_bytes, metrics->allocations);
+        if (metrics->stack_bytes == STACK_SATURATED) fprintf(out, "\"stack_bytes\": null");
+        else fprintf(out, "\"stack_bytes\": %zu", metrics->stack_bytes);
+        fprintf(out, ", \"time_min_ns\": %.0f, \"time_median_ns\": %.0f, \"time_p99_ns\": %.0f",
+            metrics->time_min_ns, metrics->time_median_ns, metrics->time_p99_ns);
+        for (int c = 0; c < HW_COUNTER_COUNT; c++) {
+            if (metrics->hw[c] < 0) fprintf(out, ", \"%s\": null", hw_keys[c]);
+            else fprintf(out, ", \"%s\": %lld", hw_keys[c], metrics->hw[c]);
+        }
+        fprintf(out, "}");
+    }
+    else {
+        char stack_text[32];
+        fprintf(out, "| %s | %s | %d | %s | %s | %lld | %lld | %zu | %lld | %s | %.0f | %.0f | %.0f |",
+            test->name, test->cmp_name, n, distribution, stable, metrics->comparisons, metrics->char_inspections, metrics->memory_bytes,
+            metrics->allocations, format_stack_bytes(metrics->stack_bytes, stack_text, sizeof(stack_text)),
+            metrics->time_min_ns, metrics->time_median_ns, metrics->time_p99_ns);
+        for (int c = 0; c < HW_COUNTER_COUNT; c++) {
+            if (metrics->hw[c] < 0) fprintf(out, " N/A |");
+            else fprintf(out, " %lld |", metrics->hw[c]);
+        }
+        fprintf(out, "\n");
+    }
+    fflush(out);
+}
+
+void write_result_footer(FILE* out, OutputFormat format) {
+    if (format == FORMAT_JSON) fprintf(out, "\n]\n");
+}
+
+// --external: sorts cfg->data_path into cfg->external_path and reports the run on stdout
+int run_external_cli(const RunnerConfig* cfg) {
+    int algorithm = -1;
+    if (cfg->algorithm_count > 0) {
+        algorithm = cfg->algorithms[0];
+    }
+    else {
+        for (int i = 0; i < ALGORITHM_COUNT; i++) {
+            if (strcmp(algorithm_registry[i].id, "merge") == 0) algorithm = i;
+        }
+    }
+    const SortTest* test = &algorithm_registry[algorithm].test;
+    const KeyEntry* key = &key_registry[cfg->key_count > 0 ? cfg->keys[0] : 0];
+
+    if (!test->sort_func) {
+        fprintf(stderr, "Error: %s sorts an index, not records; pick a record sort for --external.\n", test->name);
+        return 1;
+    }
+    if (test->is_radix && key_extractor_for(key->cmp) == NULL) {
+        fprintf(stderr, "Error: %s has no packed integer key for %s.\n", test->name, key->id);
+        return 1;
+    }
+    if (fixed_sort_key(test) != NULL && fixed_sort_key(test) != key->cmp) {
+        fprintf(stderr, "Error: %s ignores the requested key and cannot sort by %s.\n", test->name, key->id);
+        return 1;
+    }
+    if (is_partial_sort(test)) {
+        fprintf(stderr, "Error: %s only places part of the records; pick a full sort for --external.\n", test->name);
+        return 1;
+    }
+
+    ExternalSortConfig ext = { cfg->memory_bytes, cfg->temp_dir[0] != '\0' ? cfg->temp_dir : NULL };
+    ExternalSortStats stats;
+    uint64_t start = now_ns();
+    if (!external_sort(cfg->data_path, cfg->external_path, test->sort_func, key->cmp, &ext, &stats)) return 1;
+    double seconds = (double)(now_ns() - start) / 1e9;
+
+    printf("External sort: %s -> %s (%s, %s)\n", cfg->data_path, cfg->external_path, test->name,
+        key->cmp == compare_active_spec ? active_sort_spec_text : key->cmp_name);
+    if (stats.runs == 0) {
+        printf("  records: %lld, sorted in memory (no runs), comparisons: %lld\n", stats.records, stats.comparisons);
+    }
+    else {
+        printf("  records: %lld, runs: %d, merge passes: %d, comparisons: %lld\n",
+            stats.records, stats.runs, stats.merge_passes, stats.comparisons);
+    }
+    printf("  spilled: %.1f MB, time: %.2f s\n", (double)stats.spilled_bytes / (1024 * 1024), seconds);
+    return 0;
+}
+
+#define INDEX_QUERY_PRINT_LIMIT 10
+#define INDEX_QUERY_TIMING_REPS 1000 // A single lookup is too short to time on its own
+
+// --query: answers the lookups from the key index of cfg->data_path, building it if needed
+int run_query_cli(const RunnerConfig* cfg) {
+    int n = 0;
+    int from_cache = 0;
+    Student* data = load_students_cached(cfg->data_path, &n, &from_cache);
+    if (!data || n == 0) {
+        fprintf(stderr, "Exiting due to data loading error.\n");
+        tracked_free(data);
+        return 1;
+    }
+
+    StudentIndex index;
+    int from_file = 0;
+    uint64_t start = now_ns();
+    if (!open_student_index(cfg->data_path, data, n, &index, &from_file)) {
+        fprintf(stderr, "Error: Memory allocation failed for the key index.\n");
+        tracked_free(data);
+        return 1;
+    }
+    printf("Key index: %s%s (%d records, %.1f MB, %s in %.2f ms)\n", cfg->data_path, INDEX_SUFFIX, n,
+        (double)index.size / (1024 * 1024), from_file ? "loaded" : "built", (double)(now_ns() - start) / 1e6);
+
+    for (int q = 0; q < cfg->query_count; q++) {
+        const IndexQuery* query = &cfg->queries[q];
+        int first = 0;
+        int count = run_index_query(&index, data, query, &first);
+
+        start = now_ns();
+        for (int r = 0; r < INDEX_QUERY_TIMING_REPS; r++) {
+            int repeat_first;
+            run_index_query(&index, data, query, &repeat_first);
+        }
+        double lookup_ns = (double)(now_ns() - start) / INDEX_QUERY_TIMING_REPS;
+
+        printf("%s: %d match%s (%.0f ns per lookup)\n", cfg->query_text[q], count, count == 1 ? "" : "es", lookup_ns);
+        const uint32_t* perm = index.keys[query->key].perm;
+        for (int i = 0; i < count && i < INDEX_QUERY_PRINT_LIMIT; i++) {
+            const Student* s = &data[perm[first + i]];
+            printf("  %d,%s,%c,%d,%d,%d (total %d)\n", s->id, s->name, s->gender, s->korean, s->english, s->math, s->total_grade);
+        }
+        if (count > INDEX_QUERY_PRINT_LIMIT) printf("  ... %d more\n", count - INDEX_QUERY_PRINT_LIMIT);
+    }
+
+    free_student_index(&index);
+    tracked_free(data);
+    return 0;
+}
+
+int run_benchmark_cli(int argc, char* argv[]) {
+    RunnerConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    strcpy(cfg.data_path, DATA_FILENAME);
+    cfg.seed = RUNNER_DEFAULT_SEED;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_runner_usage(stdout);
+            return 0;
+        }
+        if (strcmp(arg, "--list") == 0) {
+            print_runner_registries(stdout);
+            return 0;
+        }
+
+        char name[RUNNER_TOKEN_LEN];
+        const char* value = NULL;
+        if (strcmp(arg, "-o") == 0) {
+            strcpy(name, "output");
+        }
+        else if (strncmp(arg, "--", 2) == 0 && strlen(arg + 2) < sizeof(name)) {
+            strcpy(name, arg + 2);
+            char* eq = strchr(name, '=');
+            if (eq) { // --option=value
+                *eq = '\0';
+                value = arg + 2 + (eq - name) + 1;
+            }
+        }
+        else {
+            fprintf(stderr, "Error: Unexpected argument '%s'.\n", arg);
+            print_runner_usage(stderr);
+            return 1;
+        }
+
+        if (!value) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: Missing value for %s.\n", arg);
+                return 1;
+            }
+            value = argv[++i];
+        }
+        if (!apply_runner_option(&cfg, name, value)) return 1;
+    }
+
+    if (cfg.external_path[0] != '\0') {
+        return run_external_cli(&cfg);
+    }
+    if (cfg.query_count > 0) {
+        return run_query_cli(&cfg);
+    }
+    if (cfg.algorithm_count == 0) {
+        fprintf(stderr, "Error: No algorithm selected (--algo, see --list).\n");
+        return 1;
+    }
+    if (cfg.key_count == 0) cfg.keys[cfg.key_count++] = 0;
+    if (cfg.distribution_count == 0) cfg.distributions[cfg.distribution_count++] = 0;
+    if (cfg.size_count == 0) cfg.sizes[cfg.size_count++] = 0;
+
+    // The data file is needed for the "file" distribution and for the default size
+    int needs_file = 0;
+    for (int d = 0; d < cfg.distribution_count; d++) {
+        if (cfg.distributions[d] == RUNNER_DIST_FILE) needs_file = 1;
+    }
+    for (int s = 0; s < cfg.size_count; s++) {
+        if (cfg.sizes[s] == 0) needs_file = 1;
+    }
 
-        // 3. Free copied data
-        free(arr);
+    Student* source = NULL;
+    int source_count = 0;
+    if (needs_file) {
+        int from_cache = 0;
+        source = load_students_cached(cfg.data_path, &source_count, &from_cache);
+        if (!source || source_count == 0) {
+            fprintf(stderr, "Exiting due to data loading error.\n");
+            tracked_free(source);
+            return 1;
+        }
+    }
+
+    FILE* out = stdout;
+    if (cfg.output_path[0] != '\0') {
+        out = fopen(cfg.output_path, "w");
+        if (!out) {
+            fprintf(stderr, "Error: Could not open output file %s\n", cfg.output_path);
+            tracked_free(source);
+            return 1;
+        }
+    }
+
+    write_result_header(out, cfg.format);
+
+    int row = 0;
+    for (int s = 0; s < cfg.size_count; s++) {
+        int n = cfg.sizes[s] > 0 ? cfg.sizes[s] : source_count;
+        for (int d = 0; d < cfg.distribution_count; d++) {
+            const char* distribution = runner_distribution_name(cfg.distributions[d]);
+            Student* input = build_runner_input(cfg.distributions[d], n, source, source_count, cfg.seed);
+            if (!input) continue;
+
+            for (int a = 0; a < cfg.algorithm_count; a++) {
+                for (int k = 0; k < cfg.key_count; k++) {
+                    const KeyEntry* key = &key_registry[cfg.keys[k]];
+                    SortTest test = algorithm_registry[cfg.algorithms[a]].test;
+                    test.cmp_func = key->cmp;
+                    const char* cmp_name = key->cmp == compare_active_spec ? active_sort_spec_text : key->cmp_name;
+                    snprintf(test.cmp_name, sizeof(test.cmp_name), "%.*s", (int)sizeof(test.cmp_name) - 1, cmp_name);
+                    test.skip_heap_tree = key->has_duplicates;
+
+                    const char* reason = test_skip_reason(&test);
+                    if (reason) {
+                        fprintf(stderr, "Skipping %s / %s: %s\n", test.name, key->id, reason);
+                        continue;
+                    }
+
+                    SortMetrics metrics;
+                    run_test(input, n, test, &metrics);
+                    write_result_row(out, cfg.format, row++, &test, key->id, distribution, cfg.seed, n, &metrics);
+                }
+            }
+            tracked_free(input);
+        }
     }
 
-    // 4. Calculate average comparisons
-    avg_metrics->comparisons = total_metrics.comparisons / NUM_REPETITIONS;
+    write_result_footer(out, cfg.format);
+    if (out != stdout) fclose(out);
+    tracked_free(source);
+    return 0;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Any argument switches to the configurable runner
+    if (argc > 1) {
+        return run_benchmark_cli(argc, argv);
+    }
+
+    // Ordering of the compare_active_spec rows
+    if (!parse_sort_spec(DEFAULT_ORDER_SPEC, &active_sort_spec)) return 1;
+
     // 1. Load Data
     int student_count = 0;
-    Student* students = load_students(DATA_FILENAME, &student_count);
+    int from_cache = 0;
+    alloc_stats_mark();
+    long long live_before_load = alloc_stats.live_bytes;
+    Student* students = load_students_cached(DATA_FILENAME, &student_count, &from_cache);
 
     if (!students || student_count == 0) {
         fprintf(stderr, "Exiting due to data loading error.\n");
         return 1;
     }
 
-    printf("Successfully loaded %d student records from %s (Total data memory: %.2f MB)\n",
-        student_count, DATA_FILENAME, (double)sizeof(Student) * student_count / (1024 * 1024));
+    printf("Successfully loaded %d student records from %s%s (Total data memory: %.2f MB, peak while loading: %.2f MB)\n",
+        student_count, DATA_FILENAME, from_cache ? CACHE_SUFFIX : "",
+        (double)(alloc_stats.live_bytes - live_before_load) / (1024 * 1024),
+        (double)(alloc_stats.peak_bytes - live_before_load) / (1024 * 1024));
 
     // ID: Unique (Heap/Tree OK)
     // NAME, GENDER, TOTAL_GRADE: Duplicates (Heap/Tree SKIP)
@@ -629,79 +6459,163 @@ int main() {
     // --- Define All Test Cases (Assignment A and B) ---
     SortTest all_tests[] = {
         // --- Assignment A: ID Ascending (Unique Key, Heap/Tree OK) ---
-        {"Bubble Sort", bubble_sort, compare_id_asc, "ID Ascending", 0, 0},
-        {"Selection Sort", selection_sort, compare_id_asc, "ID Ascending", 0, 0},
-        {"Insertion Sort", insertion_sort, compare_id_asc, "ID Ascending", 0, 0},
-        {"Shell Sort (Basic)", shell_sort_basic, compare_id_asc, "ID Ascending", 0, 0},
-        {"Quick Sort (Basic)", quick_sort_basic, compare_id_asc, "ID Ascending", 0, 0},
-        {"Heap Sort", heap_sort, compare_id_asc, "ID Ascending", 0, 0},
-        {"Merge Sort", merge_sort, compare_id_asc, "ID Ascending", 0, 0},
-        {"Radix Sort (ID)", (void (*)(Student[], int, CompareFunc, long long*))radix_sort_id, compare_id_asc, "ID Ascending", 0, 1},
-        {"Tree Sort (Basic)", tree_sort_basic, compare_id_asc, "ID Ascending", 0, 0},
+        {"Bubble Sort", bubble_sort, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Selection Sort", selection_sort, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Insertion Sort", insertion_sort, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Shell Sort (Basic)", shell_sort_basic, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Quick Sort (Basic)", quick_sort_basic, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Heap Sort", heap_sort, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Merge Sort", merge_sort, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Radix Sort (ID)", (void (*)(Student[], int, CompareFunc, long long*))radix_sort_id, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 1},
+        {"Tree Sort (Basic)", tree_sort_basic, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
 
         // --- Assignment A: NAME Ascending (Duplicate Key, Heap/Tree SKIP) ---
-        {"Bubble Sort", bubble_sort, compare_name_asc, "NAME Ascending", 1, 0},
-        {"Selection Sort", selection_sort, compare_name_asc, "NAME Ascending", 1, 0},
-        {"Insertion Sort", insertion_sort, compare_name_asc, "NAME Ascending", 1, 0},
-        {"Shell Sort (Basic)", shell_sort_basic, compare_name_asc, "NAME Ascending", 1, 0},
-        {"Quick Sort (Basic)", quick_sort_basic, compare_name_asc, "NAME Ascending", 1, 0},
-        {"Merge Sort", merge_sort, compare_name_asc, "NAME Ascending", 1, 0},
+        {"Bubble Sort", bubble_sort, compare_name_asc, "NAME Ascending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Selection Sort", selection_sort, compare_name_asc, "NAME Ascending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Insertion Sort", insertion_sort, compare_name_asc, "NAME Ascending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Shell Sort (Basic)", shell_sort_basic, compare_name_asc, "NAME Ascending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Quick Sort (Basic)", quick_sort_basic, compare_name_asc, "NAME Ascending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Merge Sort", merge_sort, compare_name_asc, "NAME Ascending", .skip_heap_tree = 1, .is_radix = 0},
 
         // --- Assignment A: GENDER Ascending (Duplicate Key, Stable Sorts ONLY) ---
         // Bubble, Insertion, Merge are typically stable
-        {"Bubble Sort", bubble_sort, compare_gender_asc, "GENDER Ascending (Stable)", 1, 0},
-        {"Insertion Sort", insertion_sort, compare_gender_asc, "GENDER Ascending (Stable)", 1, 0},
-        {"Merge Sort", merge_sort, compare_gender_asc, "GENDER Ascending (Stable)", 1, 0},
+        {"Bubble Sort", bubble_sort, compare_gender_asc, "GENDER Ascending (Stable)", .skip_heap_tree = 1, .is_radix = 0},
+        {"Insertion Sort", insertion_sort, compare_gender_asc, "GENDER Ascending (Stable)", .skip_heap_tree = 1, .is_radix = 0},
+        {"Merge Sort", merge_sort, compare_gender_asc, "GENDER Ascending (Stable)", .skip_heap_tree = 1, .is_radix = 0},
 
         // --- Assignment A: TOTAL Grade Descending (Duplicate Key, Heap/Tree SKIP) ---
-        {"Bubble Sort", bubble_sort, compare_total_desc, "TOTAL Descending", 1, 0},
-        {"Selection Sort", selection_sort, compare_total_desc, "TOTAL Descending", 1, 0},
-        {"Insertion Sort", insertion_sort, compare_total_desc, "TOTAL Descending", 1, 0},
-        {"Shell Sort (Basic)", shell_sort_basic, compare_total_desc, "TOTAL Descending", 1, 0},
-        {"Quick Sort (Basic)", quick_sort_basic, compare_total_desc, "TOTAL Descending", 1, 0},
-        {"Merge Sort", merge_sort, compare_total_desc, "TOTAL Descending", 1, 0},
+        {"Bubble Sort", bubble_sort, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Selection Sort", selection_sort, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Insertion Sort", insertion_sort, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Shell Sort (Basic)", shell_sort_basic, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Quick Sort (Basic)", quick_sort_basic, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Merge Sort", merge_sort, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .is_radix = 0},
 
         // --- Assignment B: Improved Sorts (Using ID Ascending for comparison) ---
-        {"Shell Sort (Basic)", shell_sort_basic, compare_id_asc, "ID Ascending (Basic)", 0, 0},
-        {"Shell Sort (Improved)", shell_sort_improved, compare_id_asc, "ID Ascending (Improved)", 0, 0},
-
-        {"Quick Sort (Basic)", quick_sort_basic, compare_id_asc, "ID Ascending (Basic)", 0, 0},
-        {"Quick Sort (Improved)", quick_sort_improved, compare_id_asc, "ID Ascending (Improved)", 0, 0},
-
-        {"Tree Sort (Basic)", tree_sort_basic, compare_id_asc, "ID Ascending (Basic)", 0, 0},
-        {"AVL Tree Sort (Improved)", avl_tree_sort, compare_id_asc, "ID Ascending (Improved)", 0, 0},
+        {"Shell Sort (Basic)", shell_sort_basic, compare_id_asc, "ID Ascending (Basic)", .skip_heap_tree = 0, .is_radix = 0},
+        {"Shell Sort (Improved)", shell_sort_improved, compare_id_asc, "ID Ascending (Improved)", .skip_heap_tree = 0, .is_radix = 0},
+        {"Shell Sort (Ciura, Extended)", shell_sort_ciura, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Shell Sort (Tokuda)", shell_sort_tokuda, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Shell Sort (Sedgewick)", shell_sort_sedgewick, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Shell Sort (Pratt)", shell_sort_pratt, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+
+        {"Quick Sort (Basic)", quick_sort_basic, compare_id_asc, "ID Ascending (Basic)", .skip_heap_tree = 0, .is_radix = 0},
+        {"Quick Sort (Improved)", quick_sort_improved, compare_id_asc, "ID Ascending (Improved)", .skip_heap_tree = 0, .is_radix = 0},
+
+        {"Tree Sort (Basic)", tree_sort_basic, compare_id_asc, "ID Ascending (Basic)", .skip_heap_tree = 0, .is_radix = 0},
+        {"AVL Tree Sort (Improved)", avl_tree_sort, compare_id_asc, "ID Ascending (Improved)", .skip_heap_tree = 0, .is_radix = 0},
+
+        // --- d-ary Heap Sort with Floyd bottom-up sift-down, one row per arity ---
+        {"Heap Sort (2-ary, Bottom-Up)", heap_sort_binary, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Heap Sort (4-ary, Bottom-Up)", heap_sort_4ary, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Heap Sort (8-ary, Bottom-Up)", heap_sort_8ary, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+
+        // --- Introsort: depth-limited quick sort with insertion/heap sort fallbacks ---
+        {"Quick Sort (Introsort)", intro_sort, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Quick Sort (Introsort)", intro_sort, compare_name_asc, "NAME Ascending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Quick Sort (Introsort)", intro_sort, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .is_radix = 0},
+
+        // --- Top-k queries: only the first top_k_count records (or the median) are placed ---
+        {"Top-k Partial Sort", top_k, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Top-k Partial Sort (Introselect)", top_k_introselect, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Top-k Partial Sort", top_k, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Nth Element (Median)", nth_element_median, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .is_radix = 0},
+
+        // --- Natural Merge Sort: run detection, run stack and galloping merges ---
+        {"Merge Sort (Natural Runs)", natural_merge_sort, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Merge Sort (Natural Runs)", natural_merge_sort, compare_id_desc, "ID Descending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Merge Sort (Natural Runs)", natural_merge_sort, compare_name_asc, "NAME Ascending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Merge Sort (Natural Runs)", natural_merge_sort, compare_gender_asc, "GENDER Ascending (Stable)", .skip_heap_tree = 1, .is_radix = 0},
+        {"Merge Sort (Natural Runs)", natural_merge_sort, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .is_radix = 0},
+
+        // --- Comparator-specialized copies (inlined comparisons, see SORT_COUNT_COMPARISONS) ---
+        {"Insertion Sort (Specialized)", insertion_sort_specialized, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Shell Sort (Improved, Specialized)", shell_sort_specialized, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Heap Sort (Specialized)", heap_sort_specialized, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Quick Sort (Introsort, Specialized)", intro_sort_specialized, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Quick Sort (Introsort, Specialized)", intro_sort_specialized, compare_name_asc, "NAME Ascending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Quick Sort (Introsort, Specialized)", intro_sort_specialized, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Merge Sort (Specialized)", merge_sort_specialized, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Merge Sort (Specialized)", merge_sort_specialized, compare_name_asc, "NAME Ascending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Merge Sort (Specialized)", merge_sort_specialized, compare_gender_asc, "GENDER Ascending (Stable)", .skip_heap_tree = 1, .is_radix = 0},
+        {"Merge Sort (Specialized)", merge_sort_specialized, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .is_radix = 0},
+
+        // --- Key-Extraction Sort: packed 64-bit keys instead of Student records ---
+        {"Key Sort (Packed 64-bit)", key_sort, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Key Sort (Packed 64-bit)", key_sort, compare_gender_asc, "GENDER Ascending (Stable)", .skip_heap_tree = 1, .is_radix = 0},
+        {"Key Sort (Packed 64-bit)", key_sort, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .is_radix = 0},
+
+        // --- Radix Sort (LSD, Base 256) on packed keys: negative IDs, GENDER and TOTAL too ---
+        {"Radix Sort (LSD-256)", radix_sort_key, compare_id_desc, "ID Descending", .skip_heap_tree = 0, .is_radix = 1},
+        {"Radix Sort (LSD-256)", radix_sort_key, compare_gender_asc, "GENDER Ascending (Stable)", .skip_heap_tree = 1, .is_radix = 1},
+        {"Radix Sort (LSD-256)", radix_sort_key, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .is_radix = 1},
+
+        // --- String sort for NAME: cached 8-byte prefixes, never re-inspects a byte ---
+        {"String Sort (Multikey Quicksort)", name_string_sort, compare_name_asc, "NAME Ascending", .skip_heap_tree = 1, .is_radix = 0},
+        {"String Sort (Multikey Quicksort)", name_string_sort, compare_name_desc, "NAME Descending", .skip_heap_tree = 1, .is_radix = 0},
+
+        // --- Sort specifications: composite byte keys, MSD radix (American flag) sort ---
+        {"Radix Sort (MSD, Sort Spec)", radix_sort_spec, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Radix Sort (MSD, Sort Spec)", radix_sort_spec, compare_name_asc, "NAME Ascending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Radix Sort (MSD, Sort Spec)", radix_sort_spec, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .is_radix = 0},
+        {"Radix Sort (MSD, Sort Spec)", radix_sort_spec, compare_active_spec, DEFAULT_ORDER_SPEC, .skip_heap_tree = 1, .is_radix = 0},
+        {"Merge Sort", merge_sort, compare_active_spec, DEFAULT_ORDER_SPEC, .skip_heap_tree = 1, .is_radix = 0},
+
+        // --- Parallel Merge Sort: chunk sorts and merge-path merges across threads ---
+        {"Merge Sort (Parallel)", merge_sort_parallel, compare_id_asc, "ID Ascending", .skip_heap_tree = 0, .is_radix = 0},
+        {"Merge Sort (Parallel)", merge_sort_parallel, compare_gender_asc, "GENDER Ascending (Stable)", .skip_heap_tree = 1, .is_radix = 0},
+        {"Merge Sort (Parallel)", merge_sort_parallel, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .is_radix = 0},
+
+        // --- Indirect Mode: sort a uint32 index over the shared dataset, then gather ---
+        {"Bubble Sort (Indirect)", NULL, compare_id_asc, "ID Ascending", .index_sort_func = bubble_sort_indirect, .gather = 1},
+        {"Selection Sort (Indirect)", NULL, compare_id_asc, "ID Ascending", .index_sort_func = selection_sort_indirect, .gather = 1},
+        {"Insertion Sort (Indirect)", NULL, compare_id_asc, "ID Ascending", .index_sort_func = insertion_sort_indirect, .gather = 1},
+        {"Shell Sort (Basic, Indirect)", NULL, compare_id_asc, "ID Ascending", .index_sort_func = shell_sort_basic_indirect, .gather = 1},
+        {"Shell Sort (Improved, Indirect)", NULL, compare_id_asc, "ID Ascending", .index_sort_func = shell_sort_improved_indirect, .gather = 1},
+        {"Quick Sort (Basic, Indirect)", NULL, compare_id_asc, "ID Ascending", .index_sort_func = quick_sort_basic_indirect, .gather = 1},
+        {"Quick Sort (Improved, Indirect)", NULL, compare_id_asc, "ID Ascending", .index_sort_func = quick_sort_improved_indirect, .gather = 1},
+        {"Heap Sort (Indirect)", NULL, compare_id_asc, "ID Ascending", .index_sort_func = heap_sort_indirect, .gather = 1},
+        {"Merge Sort (Indirect)", NULL, compare_id_asc, "ID Ascending", .index_sort_func = merge_sort_indirect, .gather = 1},
+        {"Radix Sort (ID, Indirect)", NULL, compare_id_asc, "ID Ascending", .is_radix = 1, .index_sort_func = radix_sort_id_indirect, .gather = 1},
+        {"Tree Sort (Basic, Indirect)", NULL, compare_id_asc, "ID Ascending", .index_sort_func = tree_sort_basic_indirect, .gather = 1},
+        {"AVL Tree Sort (Improved, Indirect)", NULL, compare_id_asc, "ID Ascending", .index_sort_func = avl_tree_sort_indirect, .gather = 1},
+        {"Key Sort (Packed 64-bit, Indirect)", NULL, compare_id_asc, "ID Ascending", .index_sort_func = key_sort_indirect, .gather = 1},
+        {"B+-Tree Sort (Indirect)", NULL, compare_id_asc, "ID Ascending", .index_sort_func = bptree_sort_indirect, .gather = 1},
+
+        // Column (struct-of-arrays) mode: key passes read only the columns they need
+        {"Merge Sort (Columns)", NULL, compare_id_asc, "ID Ascending", .gather = 1, .column_sort_func = column_merge_sort},
+        {"Radix Sort (LSD-256, Columns)", NULL, compare_id_asc, "ID Ascending", .is_radix = 1, .gather = 1, .column_sort_func = column_radix_sort},
+        {"Merge Sort (Columns)", NULL, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .column_sort_func = column_merge_sort},
+        {"Radix Sort (LSD-256, Columns)", NULL, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .is_radix = 1, .column_sort_func = column_radix_sort},
+
+        // Index only (no gather): several keys sorted over the same loaded dataset
+        {"Merge Sort (Indirect)", NULL, compare_name_asc, "NAME Ascending", .skip_heap_tree = 1, .index_sort_func = merge_sort_indirect},
+        {"Insertion Sort (Indirect)", NULL, compare_gender_asc, "GENDER Ascending (Stable)", .skip_heap_tree = 1, .index_sort_func = insertion_sort_indirect},
+        {"Merge Sort (Indirect)", NULL, compare_gender_asc, "GENDER Ascending (Stable)", .skip_heap_tree = 1, .index_sort_func = merge_sort_indirect},
+        {"Merge Sort (Indirect)", NULL, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .index_sort_func = merge_sort_indirect},
+        {"Key Sort (Packed 64-bit, Indirect)", NULL, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .index_sort_func = key_sort_indirect},
+        {"B+-Tree Sort (Indirect)", NULL, compare_name_asc, "NAME Ascending", .skip_heap_tree = 1, .index_sort_func = bptree_sort_indirect},
+        {"B+-Tree Sort (Indirect)", NULL, compare_gender_asc, "GENDER Ascending (Stable)", .skip_heap_tree = 1, .index_sort_func = bptree_sort_indirect},
+        {"B+-Tree Sort (Indirect)", NULL, compare_total_desc, "TOTAL Descending", .skip_heap_tree = 1, .index_sort_func = bptree_sort_indirect},
     };
 
     int num_tests = sizeof(all_tests) / sizeof(SortTest);
 
-    printf("\n--- Assignment A & B: Sort Algorithm Comparison (Average of %d runs) ---\n", NUM_REPETITIONS);
-    printf("| Algorithm | Criterion | Key Duplicates | Stable Sort | Comparisons (Avg) | Memory (Bytes) |\n");
-    printf("|:---|:---|:---|:---|:---:|:---:|\n");
+    printf("\n--- Assignment A & B: Sort Algorithm Comparison (Average of %d runs) ---\n", repetition_count);
+    printf("| Algorithm | Criterion | Key Duplicates | Stable Sort | Comparisons (Avg) | Char Inspections (Avg) | Peak Memory (Bytes) "
+        "| Allocations (Avg) | Peak Stack (Bytes) | Time Min (ns) | Time Median (ns) | Time P99 (ns) | %s | %s | %s | %s |\n",
+        hw_counter_names[0], hw_counter_names[1], hw_counter_names[2], hw_counter_names[3]);
+    printf("|:---|:---|:---|:---|:---:|:---:|:---:|:---:|:---:|:---:|:---:|:---:|:---:|:---:|:---:|:---:|\n");
 
     // Run all tests
     for (int i = 0; i < num_tests; i++) {
         SortTest test = all_tests[i];
 
-        // Skip Heap/Tree for non-unique keys
-        if (test.skip_heap_tree) {
-            if (strcmp(test.name, "Heap Sort") == 0 || strcmp(test.name, "Tree Sort (Basic)") == 0 || strcmp(test.name, "AVL Tree Sort (Improved)") == 0) {
-                continue;
-            }
-        }
-
-        // Skip Radix for non-ID criteria (Radix only works for integer keys)
-        if (test.is_radix && strstr(test.cmp_name, "ID") == NULL) {
+        // Heap/Tree on duplicate keys, Radix without a packed key, unstable sorts on GENDER
+        if (test_skip_reason(&test) != NULL) {
             continue;
         }
 
-        // Skip stable sorts for non-stable algorithms on GENDER
-        if (strstr(test.cmp_name, "GENDER") != NULL) {
-            if (!(strcmp(test.name, "Bubble Sort") == 0 || strcmp(test.name, "Insertion Sort") == 0 || strcmp(test.name, "Merge Sort") == 0)) {
-                continue;
-            }
-        }
-
-
         SortMetrics avg_metrics;
         run_test(students, student_count, test, &avg_metrics);
 
@@ -709,7 +6623,7 @@ int main() {
         const char* key_dups = test.skip_heap_tree ? "YES" : "NO";
         const char* is_stable = "N/A";
         if (strstr(test.cmp_name, "GENDER") != NULL) {
-            if (strcmp(test.name, "Bubble Sort") == 0 || strcmp(test.name, "Insertion Sort") == 0 || strcmp(test.name, "Merge Sort") == 0) {
+            if (is_stable_sort(test.name)) {
                 is_stable = "YES";
             }
             else {
@@ -717,17 +6631,29 @@ int main() {
             }
         }
 
-        printf("| %s | %s | %s | %s | %lld | %zu |\n",
+        char stack_text[32];
+        printf("| %s | %s | %s | %s | %lld | %lld | %zu | %lld | %s | %.0f | %.0f | %.0f |",
             test.name,
             test.cmp_name,
             key_dups,
             is_stable,
             avg_metrics.comparisons,
-            avg_metrics.memory_bytes);
+            avg_metrics.char_inspections,
+            avg_metrics.memory_bytes,
+            avg_metrics.allocations,
+            format_stack_bytes(avg_metrics.stack_bytes, stack_text, sizeof(stack_text)),
+            avg_metrics.time_min_ns,
+            avg_metrics.time_median_ns,
+            avg_metrics.time_p99_ns);
+        for (int c = 0; c < HW_COUNTER_COUNT; c++) {
+            if (avg_metrics.hw[c] < 0) printf(" N/A |");
+            else printf(" %lld |", avg_metrics.hw[c]);
+        }
+        printf("\n");
     }
 
     // Free the original data
-    free(students);
+    tracked_free(students);
 
     return 0;
 }
\ No newline at end of file